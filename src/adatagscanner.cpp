@@ -12,6 +12,7 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 #include <QStringList>
 #include <QFile>
 
@@ -22,123 +23,126 @@
 
 AdaTagScanner::AdaTagScanner()
     : m_cfg(NULL)
-
+    ,m_data(NULL)
+    ,m_tokenIdx(0)
 {
-    QStringList keywordList = Settings::getDefaultAdaKeywordList();
-    for(int u = 0;u < keywordList.size();u++)
-    {
-        m_keywords[keywordList[u]] = true;
-    }
-
-
-
 }
 
 AdaTagScanner::~AdaTagScanner()
 {
-    clearTokenList();
 }
 
-    
+
 int AdaTagScanner::scan(QString filepath, QList<Tag> *taglist)
 {
     m_filepath = filepath;
-    
+
     // Open file
     QFile file(filepath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    if (!file.open(QIODevice::ReadOnly))
     {
         errorMsg("Failed to open '%s'", stringToCStr(filepath));
         return -1;
     }
 
-    // Read file content
-    QString text;
-    while (!file.atEnd())
+    // Map the file content (or read it if the file can not be mapped)
+    QByteArray content;
+    int size = (int)file.size();
+    uchar *mapped = (size > 0) ? file.map(0, size) : NULL;
+    if(mapped)
+        m_data = (const char*)mapped;
+    else
     {
-         QByteArray line = file.readLine();
-         text += line;
+        content = file.readAll();
+        m_data = content.constData();
+        size = content.size();
     }
 
-    tokenize(text);
+    tokenize(m_data, size);
 
     parse(taglist);
 
+    // Keep the allocated tokens for the next file
+    m_tokens.resize(0);
+    m_data = NULL;
 
-    clearTokenList();
-
+    if(mapped)
+        file.unmap(mapped);
 
     return 0;
 }
 
 
-AdaTagScanner::Token* AdaTagScanner::pushToken(char c, Token::Type type, int lineNr)
+void AdaTagScanner::pushToken(Token::Type type, int start, int length, int lineNr)
 {
-    QString text(c);
-    return pushToken(text, type, lineNr);
+    m_tokens.append(Token(type, start, length, lineNr));
 }
 
 
-AdaTagScanner::Token* AdaTagScanner::pushToken(QString text, Token::Type type, int lineNr)
+const AdaTagScanner::Token* AdaTagScanner::popToken()
 {
-    Token *tok = new Token(lineNr, type);
-    tok->setText(text);
-    m_tokens.append(tok);
-    return tok;
+    if(m_tokenIdx >= m_tokens.size())
+        return NULL;
+    return &m_tokens[m_tokenIdx++];
 }
 
-
-
-    
-AdaTagScanner::Token* AdaTagScanner::popToken()
+const AdaTagScanner::Token* AdaTagScanner::peekToken()
 {
-    if(m_tokens.isEmpty())
+    if(m_tokenIdx >= m_tokens.size())
         return NULL;
-    Token* tok = m_tokens.takeFirst();
-    return tok;
+    return &m_tokens[m_tokenIdx];
 }
 
-AdaTagScanner::Token* AdaTagScanner::peekToken()
+
+/**
+ * @brief Returns the text of a token.
+ */
+QString AdaTagScanner::getText(const Token *tok) const
 {
-    if(m_tokens.isEmpty())
-        return NULL;
-    return m_tokens.first();
+    return QString::fromUtf8(m_data + tok->m_start, tok->m_length);
 }
 
 
+/**
+ * @brief Checks if a token has a specific text.
+ */
+bool AdaTagScanner::isText(const Token *tok, const char *text) const
+{
+    int len = strlen(text);
+    if(tok->m_length != len)
+        return false;
+    return (memcmp(m_data + tok->m_start, text, len) == 0) ? true : false;
+}
+
 
-QString AdaTagScanner::Token::toDesc()
+QString AdaTagScanner::toDesc(const Token *tok) const
 {
-    Token *tok = this;
     QString typeStr;
     switch(tok->getType())
     {
         case Token::STRING: typeStr = "STRING";break;
         case Token::NUMBER: typeStr = "NUMBER";break;
-        case Token::COMMENT: typeStr = "COMMENT";break;
         case Token::WORD: typeStr = "WORD";break;
-        case Token::KEYWORD: typeStr = "KEYWORD";break;
     };
-        
+
     QString str;
-    str = QString::asprintf("[L%d;%s>%s<]", tok->m_lineNr, qPrintable(typeStr), qPrintable(tok->text));
+    str = QString::asprintf("[L%d;%s>%s<]", tok->getLineNr(), qPrintable(typeStr), qPrintable(getText(tok)));
     return str;
 }
 
 
 /**
  * @brief Removes a token if it matches.
- * @return false if a token was poped. 
+ * @return false if a token was poped.
  */
-bool AdaTagScanner::eatToken(QString text)
+bool AdaTagScanner::eatToken(const char *text)
 {
-   Token *tok = peekToken();
+    const Token *tok = peekToken();
     if(!tok)
         return true;
-    if(tok->getText() == text)
+    if(isText(tok, text))
     {
-        tok = popToken();
-        delete tok;
+        popToken();
         return false;
     }
     return true;
@@ -146,27 +150,28 @@ bool AdaTagScanner::eatToken(QString text)
 
 void AdaTagScanner::parse(QList<Tag> *taglist)
 {
-    Token *tok;
+    const Token *tok;
     enum { IDLE, STATE_PROC, STATE_FUNC} state = IDLE;
+    m_tokenIdx = 0;
     do
     {
         tok = popToken();
         if(tok)
         {
-            debugMsg("tok: %s", qPrintable(tok->toDesc()));
-                    
+            debugMsg("tok: %s", qPrintable(toDesc(tok)));
+
             switch(state)
             {
                 case IDLE:
                 {
-                    if(tok->getText() == "procedure")
+                    if(isText(tok, "procedure"))
                         state = STATE_PROC;
-                    else if(tok->getText() == "function")
+                    else if(isText(tok, "function"))
                         state = STATE_FUNC;
                 };break;
                 case STATE_PROC:
                 {
-                    QString name = tok->getText();
+                    QString name = getText(tok);
                     int lineNr = tok->getLineNr();
                     // Parse signature
                     if(!eatToken("is"))
@@ -177,24 +182,23 @@ void AdaTagScanner::parse(QList<Tag> *taglist)
                         tag.m_name = name;
                         tag.m_filepath = m_filepath;
                         tag.m_type = Tag::TAG_FUNC;
-                    
-                        QString tokText;
+
                         QString signature;
                         signature += "(";
                         signature += ")";
                         debugMsg("Found signature:%s", qPrintable(signature));
                         tag.setSignature(signature);
-                    
+
                         // Add the tag to the list
                         taglist->append(tag);
                     }
 
                     state = IDLE;
-                    
+
                 };break;
                 case STATE_FUNC:
                 {
-                    QString name = tok->getText();
+                    QString name = getText(tok);
                     int lineNr = tok->getLineNr();
 
                     debugMsg("found: '%s' at L%d", qPrintable(name), lineNr);
@@ -203,25 +207,17 @@ void AdaTagScanner::parse(QList<Tag> *taglist)
                     tag.m_name = name;
                     tag.m_filepath = m_filepath;
                     tag.m_type = Tag::TAG_FUNC;
-                    
+
                     // Parse signature
-                    QString tokText;
                     QString signature;
                     signature += "(";
+                    const Token *tok2;
                     do
                     {
-                        Token *tok2;
                         tok2 = popToken();
-                        if(tok2)
-                        {
-                            tokText = tok2->getText();
-                            delete tok2;
-                        }
-                        else
-                            tokText = "";
-
-                        if(tokText != "is")
+                        if(tok2 && !isText(tok2, "is"))
                         {
+                            QString tokText = getText(tok2);
                             if(tokText == "(" || tokText == ")" || tokText == ";")
                                 signature += tokText + " ";
                             else if(tokText == "return")
@@ -232,43 +228,25 @@ void AdaTagScanner::parse(QList<Tag> *taglist)
                                 signature += tokText;
                         }
 
-                    }while(tokText != "is" && tokText != "");
+                    }while(tok2 && !isText(tok2, "is"));
                     signature += ")";
-                    
+
                     debugMsg("Found signature:%s", qPrintable(signature));
                     tag.setSignature(signature);
-                
+
                     // Add the tag to the list
                     taglist->append(tag);
-                
+
 
                     state = IDLE;
-                    
+
                 };break;
                 default:;break;
             }
-            delete tok;
         }
     }while(tok);
 
 }
-    
-
-
-
-
-void AdaTagScanner::clearTokenList()
-{
-    for(int i = 0;i < m_tokens.size();i++)
-    {
-        Token* tok = m_tokens[i];
-        delete tok;
-    }
-    m_tokens.clear();
-
-
-
-}
 
 
 bool AdaTagScanner::isSpecialChar(char c) const
@@ -291,33 +269,6 @@ bool AdaTagScanner::isSpecialChar(char c) const
         return false;
 }
 
-bool AdaTagScanner::isSpecialChar(TextField *field) const
-{
-    if(field->m_text.size() == 1)
-    {
-        return isSpecialChar(field->m_text[0].toLatin1());
-    }
-    return false;
-}
-
-
-
-
-bool AdaTagScanner::isKeyword(QString text) const
-{
-    if(text.size() == 0)
-        return false;
-    if(m_keywords.contains(text))
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
-}
-
-
 
 void AdaTagScanner::setConfig(Settings *cfg)
 {
@@ -325,183 +276,69 @@ void AdaTagScanner::setConfig(Settings *cfg)
 
 }
 
-void AdaTagScanner::tokenize(QString text2)
+
+/**
+ * @brief Splits the (UTF-8) file content into tokens.
+ *
+ * Comments and whitespaces are skipped.
+ */
+void AdaTagScanner::tokenize(const char *data, int size)
 {
     int lineNr = 1;
-    enum {IDLE,
-        SPACES,
-        WORD, COMMENT1,COMMENT,
-        STRING,
-        ESCAPED_CHAR,
-        MINUS
-    } state = IDLE;
-    char c = '\n';
-    char prevC = ' ';
-    char prevPrevC = ' ';
-    bool isEscaped = false;
-    QString text;
-
-
-    clearTokenList();
-    
-
-    for(int i = 0;i < text2.size();i++)
-    {
-        c = text2[i].toLatin1();
+    int i = 0;
 
-        if(prevC != '\\' && c == '\n')
-            lineNr++;
+    m_tokens.resize(0);
 
-        // Was the last character an escape?
-        if(prevC == '\\' && prevPrevC != '\\')
-            isEscaped = true;
-        else
-            isEscaped = false;
-        prevPrevC = prevC;
-        
-        
-        switch(state)
-        {   
-            case IDLE:
-            {
-                text = "";
-                if(c == '-')
-                {
-                    text = "-";
-                    state = COMMENT1;
-                }
-                else if(c == ' ' || c == '\t')
-                {
-                    state = SPACES;
-                }
-                else if(c == '\'')
-                {
-                    state = ESCAPED_CHAR;
-                }
-                else if(c == '"')
-                {
-                    state = STRING;
-                }
-                // An '->' token?
-                else if(c == '-')
-                {
-                    state = MINUS;
-                }
-                else if(isSpecialChar(c))
-                {
-                    pushToken(c, Token::WORD, lineNr);
-                }
-                else if(c == '\n')
-                {
-                    state = IDLE;
-                }
-                else
-                {
-                    text = c;
-                    state = WORD;
-                }
-            };break;
-            case MINUS:
-            {
-                if(c == '>')
-                {
-                    pushToken("->", Token::WORD, lineNr);
-                }
-                else
-                {
-                    pushToken(c, Token::WORD, lineNr);
-                }
-                state = IDLE;
-            };break;
-            case COMMENT1:
-            {
-                if(c == '-')
-                {
-                    text += c;
-                    state = COMMENT;
-                }
-                else
-                {
-                    i--;
-                    state = IDLE;
-                }
-            };break;
-            case COMMENT:
-            {
-                if(c == '\n')
-                {
-                    pushToken(text, Token::COMMENT, lineNr-1);
-                    state = IDLE;
-                }
-                else
-                    text += c;
-                    
-            };break;
-            case SPACES:
-            {
-                if(c == ' ' || c == '\t')
-                {
-                                                              
-                }
-                else
-                {
-                    i--;
-                    state = IDLE;
-                }  
-            };break;
-            case ESCAPED_CHAR:
-            {
-                text += c;
-                if(!isEscaped && c == '\'')
-                {
-                    pushToken(text, Token::STRING, lineNr);
-                    state = IDLE;
-                }
-            };break;
-            case STRING:
+    while(i < size)
+    {
+        char c = data[i];
+        if(c == '\n')
+        {
+            lineNr++;
+            i++;
+        }
+        else if(c == ' ' || c == '\t' || c == '\r')
+            i++;
+        // Comment?
+        else if(c == '-' && i+1 < size && data[i+1] == '-')
+        {
+            while(i < size && data[i] != '\n')
+                i++;
+        }
+        // A string or a character (but not an attribute tick such as X'First)?
+        else if(c == '"' || (c == '\'' && i+2 < size && data[i+2] == '\''))
+        {
+            int start = i;
+            int startLineNr = lineNr;
+            for(i = i+1;i < size && data[i] != c;i++)
             {
-                text += c;
-                if(!isEscaped && c == '"')
-                {
-                    pushToken(text, Token::STRING, lineNr);
-                    state = IDLE;
-                }
-                  
-            };break;
-            case WORD:
+                if(data[i] == '\n')
+                    lineNr++;
+            }
+            if(i < size)
+                i++;
+            pushToken(Token::STRING, start, i-start, startLineNr);
+        }
+        else if(isSpecialChar(c))
+        {
+            pushToken(Token::WORD, i, 1, lineNr);
+            i++;
+        }
+        else
+        {
+            int start = i;
+            for(i = i+1;i < size;i++)
             {
-                if(isSpecialChar(c) || c == ' ' || c == '\t' || c == '\n')
-                {
-                    if(c != '\n')
-                        i--;
-
-                    if(QChar(text[0]).isDigit())
-                        pushToken(text, Token::NUMBER, lineNr);
-                    else
-                    {
-                     
-                        if(isKeyword(text))
-                            pushToken(text, Token::KEYWORD, lineNr);
-                        else
-                            pushToken(text, Token::WORD, lineNr);
-                    }
-
-                    state = IDLE;
-                }
-                else
-                {
-                    
-                    text += c;
-                }
-                
-            };break;
+                c = data[i];
+                if(isSpecialChar(c) || c == ' ' || c == '\r' || c == '\n' || c == '"' || c == '\'')
+                    break;
+            }
+            if(data[start] >= '0' && data[start] <= '9')
+                pushToken(Token::NUMBER, start, i-start, lineNr);
+            else
+                pushToken(Token::WORD, start, i-start, lineNr);
         }
-        prevC = c;
     }
-
-    
 }
 
 
-
-
@@ -9,77 +9,69 @@
 #ifndef FILE__ADATAGS_H
 #define FILE__ADATAGS_H
 
+#include <QVector>
+
 #include "tagscanner.h"
-#include "syntaxhighlighter.h"
 
 
 /**
  * @brief Tag scanner for the Ada language.
  *
- * This class scans a rust language file and extract function definitions from it.
+ * This class scans an Ada language file and extract function definitions from it.
+ * The file is memory mapped and tokenized in a single pass. The tokens only
+ * refers to the mapped data and the token list is reused between files.
  */
 class AdaTagScanner
 {
 public:
-    
+
     AdaTagScanner();
     virtual ~AdaTagScanner();
 
     int scan(QString filepath, QList<Tag> *taglist);
-       
-
-    void setConfig(Settings *cfg);
-
-private:
-
-    void tokenize(QString text);
 
-    void reset();
 
-    bool isKeyword(QString text) const;
-    bool isSpecialChar(char c) const;
-    bool isSpecialChar(TextField *field) const;
+    void setConfig(Settings *cfg);
 
 private:
     class Token
     {
     public:
-        typedef enum {STRING, COMMENT, NUMBER,WORD, KEYWORD} Type;
+        typedef enum {STRING, NUMBER, WORD} Type;
 
-        Token(int lineNr) : m_lineNr(lineNr) {};
-        Token(int lineNr, Type t) : m_type(t), m_lineNr(lineNr) {};
+        Token() : m_type(WORD), m_start(0), m_length(0), m_lineNr(0) {};
+        Token(Type t, int start, int length, int lineNr)
+            : m_type(t), m_start(start), m_length(length), m_lineNr(lineNr) {};
 
-        QString getText() const { return text;};
-        void setText(QString txt) { text = txt;};
-
-        QString toDesc();
-        
-        void setType(Type t) { m_type = t; };
         Type getType() const { return m_type; };
-
         int getLineNr() const { return m_lineNr; };
 
-    private:
         Type m_type;
-        QString text;
+        int m_start; //!< Offset in the file content.
+        int m_length; //!< Number of bytes.
         int m_lineNr;
     };
 
+    void tokenize(const char *data, int size);
     void parse(QList<Tag> *taglist);
 
+    bool isSpecialChar(char c) const;
+
 private:
-    bool eatToken(QString text);
-    Token* popToken();
-    Token* peekToken();
-    Token* pushToken(QString text, Token::Type type, int lineNr);
-    Token* pushToken(char text, Token::Type type, int lineNr);
-    void clearTokenList();
-    
+    QString getText(const Token *tok) const;
+    bool isText(const Token *tok, const char *text) const;
+    QString toDesc(const Token *tok) const;
+    bool eatToken(const char *text);
+    const Token* popToken();
+    const Token* peekToken();
+    void pushToken(Token::Type type, int start, int length, int lineNr);
+
 private:
     Settings *m_cfg;
-    QHash <QString, bool> m_keywords;
     QString m_filepath;
-    QList<Token*> m_tokens;
+    const char *m_data; //!< Content of the file being scanned.
+    QVector<Token> m_tokens;
+    int m_tokenIdx; //!< Index of the next token to pop.
 };
 
 #endif // FILE__ADATAGS_H
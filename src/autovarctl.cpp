@@ -453,8 +453,11 @@ void AutoVarCtl::ICore_onLocalVarChanged(QStringList varNames)
 
     clear();
 
+    // (The watches are only created the first time the frame is shown)
+    Core &core = Core::getInstance();
+    QList<VarWatch*> watchList = core.gdbGetFrameVarWatches(varNames);
     for(int i = 0;i < varNames.size();i++)
-        addNewWatch(varNames[i]);
+        addNewWatch(varNames[i], watchList[i]);
 
 }
 
@@ -508,35 +511,10 @@ QString AutoVarCtl::getDisplayString(QString watchId, QString varPath)
 void AutoVarCtl::clear()
 {
     QTreeWidget *autoWidget = m_autoWidget;
-    QTreeWidgetItem *rootItem = m_autoWidget->invisibleRootItem();
 
     debugMsg("%s()", __func__);
 
-    // Get all items
-    QList<QTreeWidgetItem *>items;
-    for(int i =0;i < rootItem->childCount();i++)
-    {
-        QTreeWidgetItem *item = rootItem->child(i);
-
-        items.push_back(item);
-    }
-    
-
-    // Loop through the items
-    while(!items.isEmpty())
-    {
-        QTreeWidgetItem *item = items.takeFirst();
-    
-        // Delete the item
-        Core &core = Core::getInstance();
-        QString watchId = getWatchId(item);
-        if(watchId != "")
-        {
-            //debugMsg("calling gdbRemoveVarWatch('%s')", stringToCStr(watchId));
-            core.gdbRemoveVarWatch(watchId);
-        }
-    }
-
+    // (The watches are kept by the core to be reused when the frame is selected again)
     autoWidget->clear();
 
 }
@@ -657,19 +635,16 @@ void AutoVarCtl::selectedChangeDisplayFormat(VarCtl::DispFormat fmt)
 
 
 /**
- * @brief Adds a new watch item
- * @param varName    The expression to add as a watch.
+ * @brief Adds an item for a watch that has been created for a variable.
+ * @param varName    The name of the variable.
+ * @param watch      The watch (or NULL if the watch could not be created).
  */
-void AutoVarCtl::addNewWatch(QString varName)
+void AutoVarCtl::addNewWatch(QString varName, VarWatch *watch)
 {
-    QString newName = varName;
-    Core &core = Core::getInstance();
-    
     //debugMsg("%s('%s')", __func__, stringToCStr(varName));
 
 
-        VarWatch *watch = NULL;
-        if(core.gdbAddVarWatch(newName, &watch) == 0)
+        if(watch)
         {
             QString watchId = watch->getWatchId();
             QString varType = watch->getVarType();
@@ -34,7 +34,7 @@ public:
     void ICore_onWatchVarChanged(VarWatch &watch);
     void ICore_onWatchVarChildAdded(VarWatch &watch);
     void ICore_onWatchVarDeleted(VarWatch &watch);
-    void addNewWatch(QString varName);
+    void addNewWatch(QString varName, VarWatch *watch);
 
 
     void setConfig(Settings *cfg);
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2014-2020 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+//#define ENABLE_DEBUGMSG
+
+#include "breakpointsaver.h"
+
+#include <QMutexLocker>
+
+#include "settings.h"
+#include "log.h"
+
+
+BreakpointSaver::BreakpointSaver()
+    : m_quit(false)
+    ,m_hasPending(false)
+{
+}
+
+BreakpointSaver::~BreakpointSaver()
+{
+}
+
+
+void BreakpointSaver::requestQuit()
+{
+    QMutexLocker locker(&m_mutex);
+    m_quit = true;
+    m_wait.wakeAll();
+}
+
+
+/**
+ * @brief Queues a list of breakpoints to be written. Replaces any list that has not been written yet.
+ */
+void BreakpointSaver::queueSave(QString filepath, QStringList breakpointStringList)
+{
+    QMutexLocker locker(&m_mutex);
+    m_filepath = filepath;
+    m_breakpointStringList = breakpointStringList;
+    m_hasPending = true;
+    m_wait.wakeAll();
+}
+
+
+void BreakpointSaver::run()
+{
+    m_mutex.lock();
+    while(m_hasPending || m_quit == false)
+    {
+        if(!m_hasPending)
+            m_wait.wait(&m_mutex);
+        else
+        {
+            QString filepath = m_filepath;
+            QStringList breakpointStringList = m_breakpointStringList;
+            m_hasPending = false;
+            m_mutex.unlock();
+
+            Settings::saveBreakpoints(filepath, breakpointStringList);
+
+            m_mutex.lock();
+        }
+    }
+    m_mutex.unlock();
+}
+
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2014-2020 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__BREAKPOINTSAVER_H
+#define FILE__BREAKPOINTSAVER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QStringList>
+
+
+/**
+ * @brief Thread that writes the breakpoints to the project config file.
+ *
+ * Only the latest queued list is kept. If several lists are queued while
+ * a file is being written only the last one is written afterwards.
+ * A pending list is always written before the thread quits.
+ */
+class BreakpointSaver : public QThread
+{
+public:
+    BreakpointSaver();
+    virtual ~BreakpointSaver();
+
+    void run();
+    void requestQuit();
+
+    void queueSave(QString filepath, QStringList breakpointStringList);
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_wait;
+    bool m_quit;
+    bool m_hasPending; //!< True if a list is waiting to be written.
+    QString m_filepath;
+    QStringList m_breakpointStringList;
+};
+
+
+#endif // FILE__BREAKPOINTSAVER_H
@@ -15,6 +15,7 @@
 #include <QPaintEvent>
 #include <QColor>
 #include <assert.h>
+#include <algorithm>
 
 #include "log.h"
 #include "syntaxhighlighter.h"
@@ -227,12 +228,16 @@ void CodeView::paintEvent ( QPaintEvent * event )
     painter.fillRect(rect, borderColor);
 
 
-    // Show breakpoints
-    for(int j = 0;j < m_breakpointList.size();j++)
+    // Show breakpoints (only the ones in the area to paint)
+    int firstLineNo = std::max(0,(paintRect.top()/rowHeight) - 1) + 1;
+    QVector<int>::const_iterator bkptIter = std::lower_bound(m_breakpointList.constBegin(), m_breakpointList.constEnd(), firstLineNo);
+    for(;bkptIter != m_breakpointList.constEnd();++bkptIter)
     {
-        int lineNo = m_breakpointList[j];
+        int lineNo = *bkptIter;
         int rowIdx = lineNo-1;
         int y = rowHeight*rowIdx;
+        if(y > paintRect.bottom())
+            break;
         QRect rect2(2,y,getBorderWidth()-3,rowHeight);
         painter.fillRect(rect2, Qt::blue);
     }
@@ -511,8 +516,12 @@ void CodeView::mouseDoubleClickEvent( QMouseEvent * event )
 }
 
 
+/**
+ * @brief Sets the lines that has a breakpoint.
+ */
 void CodeView::setBreakpoints(QVector<int> numList)
 {
+    std::sort(numList.begin(), numList.end());
     m_breakpointList = numList;
     update();
 }   
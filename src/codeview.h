@@ -91,7 +91,7 @@ public:
     QFontMetrics *m_fontInfo;
     int m_cursorY;
     ICodeView *m_inf;
-    QVector<int> m_breakpointList;
+    QVector<int> m_breakpointList; //!< Lines with a breakpoint (sorted).
     SyntaxHighlighter *m_highlighter;
     Settings *m_cfg;
     QString m_text;
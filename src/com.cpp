@@ -11,6 +11,7 @@
 #include <QDateTime>
 #include <QByteArray>
 #include <QDebug>
+#include <QEventLoop>
 #include <unistd.h>
 #include <assert.h>
 #include <sys/time.h>
@@ -32,6 +33,7 @@ const char* GdbCom::asyncClassToString(GdbComListener::AsyncClass ac)
         case GdbComListener::AC_THREAD_GROUP_ADDED:return "thread_group_added";break;
         case GdbComListener::AC_THREAD_GROUP_STARTED:return "thread_group_started";break;
         case GdbComListener::AC_LIBRARY_LOADED:return "library_loaded";break;
+        case GdbComListener::AC_BREAKPOINT_CREATED: return "breakpoint_created";break;
         case GdbComListener::AC_BREAKPOINT_MODIFIED: return "breakpoint_modified";break;
         case GdbComListener::AC_BREAKPOINT_DELETED: return "breakpoint_deleted";break;
         case GdbComListener::AC_THREAD_EXITED: return "thread_exited";break;
@@ -94,6 +96,9 @@ GdbCom::GdbCom()
  ,m_logFile(GDB_LOG_FILE)
  ,m_busy(0)
  ,m_enableLog(false)
+ ,m_backgroundPending(false)
+ ,m_backgroundResult(GDB_DONE)
+ ,m_backgroundLoop(NULL)
  {
 /*
     QByteArray array = m_process.readAllStandardOutput();
@@ -370,6 +375,10 @@ int GdbCom::parseAsyncOutput(Resp *resp, GdbComListener::AsyncClass *ac)
     {
         *ac = GdbComListener::AC_LIBRARY_LOADED;
     }
+    else if(acString == "breakpoint-created")
+    {
+        *ac = GdbComListener::AC_BREAKPOINT_CREATED;
+    }
     else if(acString == "breakpoint-modified")
     {
         *ac = GdbComListener::AC_BREAKPOINT_MODIFIED;
@@ -763,6 +772,7 @@ Resp *GdbCom::parseResultRecord()
         PendingCommand cmd = m_pending.takeFirst();
 
         debugMsg("%s done", stringToCStr(cmd.m_cmdText));
+        resp->m_isBackgroundResult = cmd.m_inBackground;
     }
 
     resp->setType(Resp::RESULT);
@@ -945,6 +955,16 @@ int GdbCom::readFromGdb(GdbResult *m_result, Tree *m_resultData)
             
                 m_resultData->copy(resp->tree);
             }
+
+            // The result of the command sent with commandInBackground()?
+            if(resp->getType() == Resp::RESULT && resp->m_isBackgroundResult)
+            {
+                m_backgroundResult = resp->m_result;
+                m_backgroundResultData.copy(resp->tree);
+                m_backgroundPending = false;
+                if(m_backgroundLoop)
+                    m_backgroundLoop->quit();
+            }
         }
 
     }
@@ -1021,6 +1041,8 @@ GdbResult GdbCom::command(Tree *resultData, QString text)
     int rc = 0;
 
     assert(m_busy == 0);
+
+    waitForBackgroundCommand();
     
     m_busy++;
     
@@ -1086,16 +1108,114 @@ GdbResult GdbCom::command(Tree *resultData, QString text)
 }
 
 
+/**
+ * @brief Sends several commands to gdb and waits for the results of all of them.
+ *
+ * All the commands are written to gdb at once so that gdb can process
+ * them back to back without waiting for gede to read each result.
+ * @param resultDataList    Receives the result data of each command (entries may be NULL).
+ * @param dispatchResults   False if the results should not be passed on to the listener.
+ * @return The result of each command.
+ */
+QVector<GdbResult> GdbCom::commandBatch(QStringList cmdList, QList<Tree*> resultDataList, bool dispatchResults)
+{
+    Tree resultDataNull;
+    QVector<GdbResult> resultList(cmdList.size(), GDB_ERROR);
+    int rc = 0;
+
+    assert(m_busy == 0);
+
+    waitForBackgroundCommand();
+    assert(m_pending.isEmpty());
+
+    if(cmdList.isEmpty())
+        return resultList;
+
+    m_busy++;
+
+    for(int i = 0;i < resultDataList.size();i++)
+    {
+        if(resultDataList[i])
+            resultDataList[i]->removeAll();
+    }
+
+    // Send all the commands to gdb
+    QString text;
+    for(int i = 0;i < cmdList.size();i++)
+    {
+        debugMsg("# Cmd: '%s'", stringToCStr(cmdList[i]));
+
+        PendingCommand cmd;
+        cmd.m_cmdText = cmdList[i];
+        m_pending.push_back(cmd);
+
+        text += cmdList[i] + "\n";
+    }
+    m_process.write(text.toLatin1());
+
+    if(m_enableLog)
+    {
+        writeLogEntry("\n");
+        for(int i = 0;i < cmdList.size();i++)
+            writeLogEntry("<< " + cmdList[i] + "\n");
+    }
+
+    // Read the results in the same order as the commands was sent
+    while(!m_pending.isEmpty() && rc == 0)
+    {
+        int cmdIdx = cmdList.size() - m_pending.size();
+        Tree *resultData = &resultDataNull;
+        if(cmdIdx < resultDataList.size() && resultDataList[cmdIdx] != NULL)
+            resultData = resultDataList[cmdIdx];
+
+        GdbResult result;
+        if(readFromGdb(&result, resultData))
+            rc = -1;
+        else if(cmdList.size() - m_pending.size() > cmdIdx)
+            resultList[cmdIdx] = result;
+    }
+
+    while(!m_list.isEmpty())
+    {
+        readFromGdb(NULL, &resultDataNull);
+    }
+
+    // Remove the results that should not be dispatched
+    if(!dispatchResults)
+    {
+        for(int i = m_respQueue.size()-1;i >= 0;i--)
+        {
+            if(m_respQueue[i]->getType() == Resp::RESULT)
+                delete m_respQueue.takeAt(i);
+        }
+    }
+
+    m_busy--;
+
+    dispatchResp();
+
+    onReadyReadStandardOutput();
+
+    return resultList;
+}
+
+
 /**
  * @brief Starts gdb
+ * @param earlyCommands   Commands to execute before gdb reads its init files (passed with -iex).
  * @return 0 on success and gdb was started.
  */
-int GdbCom::init(QString gdbPath, bool enableDebugLog)
+int GdbCom::init(QString gdbPath, bool enableDebugLog, QStringList earlyCommands)
 {
     enableLog(enableDebugLog);
 
     QStringList gdbArgs;
     gdbArgs.append("--interpreter=mi2");
+    for(int i = 0;i < earlyCommands.size();i++)
+    {
+        gdbArgs.append("-iex");
+        gdbArgs.append(earlyCommands[i]);
+    }
 
     if(m_enableLog)
     {
@@ -1138,6 +1258,67 @@ GdbCom& GdbCom::getInstance()
 
 
 
+/**
+ * @brief Sends a command that may take a long time and processes events until gdb has answered.
+ *
+ * Used to keep the gui responsive while gdb loads the symbols of a huge
+ * program. A command sent in the meantime blocks until the result has been
+ * received so the gui that sends commands is disabled while loading.
+ * @return The result or GDB_EXIT if the application quit (or gdb died) before the result was received.
+ */
+GdbResult GdbCom::commandInBackground(Tree *resultData, QString text)
+{
+    assert(m_busy == 0);
+    assert(m_pending.isEmpty());
+
+    debugMsg("# Cmd: '%s'", stringToCStr(text));
+
+    PendingCommand cmd;
+    cmd.m_cmdText = text;
+    cmd.m_inBackground = true;
+    m_pending.push_back(cmd);
+    m_backgroundPending = true;
+    m_backgroundResultData.removeAll();
+
+    m_process.write((text + "\n").toLatin1());
+
+    if(m_enableLog)
+    {
+        writeLogEntry("\n");
+        writeLogEntry("<< " + text + "\n");
+    }
+
+    // The result is received by onReadyReadStandardOutput()
+    QEventLoop loop;
+    m_backgroundLoop = &loop;
+    if(m_backgroundPending)
+        loop.exec();
+    m_backgroundLoop = NULL;
+
+    if(m_backgroundPending)
+        return GDB_EXIT;
+    if(resultData)
+        resultData->copy(m_backgroundResultData);
+    return m_backgroundResult;
+}
+
+
+/**
+ * @brief Waits for the result of the command sent with commandInBackground() (if any).
+ *
+ * Needed before another command is sent since gdb answers the commands in order.
+ */
+void GdbCom::waitForBackgroundCommand()
+{
+    while(m_backgroundPending)
+    {
+        Tree resultDataNull;
+        if(readFromGdb(NULL, &resultDataNull))
+            break;
+    }
+}
+
+
 void GdbCom::onReadyReadStandardError ()
 {
     // Dump all stderr content
@@ -1168,7 +1349,7 @@ void GdbCom::onReadyReadStandardOutput ()
         Tree resultDataNull;
         readFromGdb(NULL, &resultDataNull);
 
-        assert(m_pending.isEmpty() == true);
+        assert(m_pending.isEmpty() == true || m_backgroundPending);
     }
     
     dispatchResp();
@@ -1273,6 +1454,10 @@ void GdbCom::onGdbStateChanged ( QProcess::ProcessState newState )
     if(newState == QProcess::NotRunning)
     {
         critMsg("GDB unexpected terminated");
+
+        // Stop waiting for a result that will never come
+        if(m_backgroundLoop)
+            m_backgroundLoop->quit();
     }
 }
 
@@ -12,11 +12,15 @@
 
 #include <QProcess>
 #include <QList>
+#include <QVector>
+#include <QStringList>
 #include <QFile>
 #include <assert.h>
 #include "tree.h"
 #include "config.h"
 
+class QEventLoop;
+
 
 class Token
 {
@@ -77,6 +81,7 @@ private:
             AC_THREAD_GROUP_ADDED,
             AC_THREAD_GROUP_STARTED,
             AC_LIBRARY_LOADED,
+            AC_BREAKPOINT_CREATED,
             AC_BREAKPOINT_MODIFIED,
             AC_BREAKPOINT_DELETED,
             AC_THREAD_EXITED,
@@ -111,9 +116,10 @@ enum GdbResult
 class PendingCommand
 {
     public:
-        PendingCommand() {};
+        PendingCommand() : m_inBackground(false) {};
 
         QString m_cmdText;
+        bool m_inBackground; //!< True if sent with commandInBackground().
 
 
 };
@@ -122,7 +128,7 @@ class PendingCommand
 class Resp
 {
     public:
-        Resp() : m_type(UNKNOWN) {};
+        Resp() : m_type(UNKNOWN), m_isBackgroundResult(false) {};
 
         typedef enum {
             UNKNOWN = 0,
@@ -153,6 +159,7 @@ class Resp
         Tree tree;
         GdbComListener::AsyncClass reason;
         GdbResult m_result;
+        bool m_isBackgroundResult; //!< True if the result of a command sent with commandInBackground().
         
         
 };
@@ -174,7 +181,7 @@ class GdbCom : public QObject
         static const char* asyncClassToString(GdbComListener::AsyncClass ac);
 
         static GdbCom& getInstance();
-        int init(QString gdbPath, bool enableDebugLog);
+        int init(QString gdbPath, bool enableDebugLog, QStringList earlyCommands = QStringList());
 
         void setListener(GdbComListener *listener) { m_listener = listener; };
 
@@ -182,6 +189,9 @@ class GdbCom : public QObject
 
         GdbResult commandF(Tree *resultData, const char *cmd, ...);
         GdbResult command(Tree *resultData, QString cmd);
+        QVector<GdbResult> commandBatch(QStringList cmdList, QList<Tree*> resultDataList, bool dispatchResults = true);
+        GdbResult commandInBackground(Tree *resultData, QString cmd);
+        bool isBackgroundCommandPending() const { return m_backgroundPending; };
 
         static QList<Token*> tokenize(QString str);
 
@@ -219,6 +229,7 @@ class GdbCom : public QObject
         bool isTokenPending();
         void readTokens();
         void writeLogEntry(QString logText);
+        void waitForBackgroundCommand();
         
     private:
         QProcess m_process;
@@ -232,6 +243,10 @@ class GdbCom : public QObject
         QByteArray m_inputBuffer; //!< List of raw characters received from the GDB process.
         int m_busy;
         bool m_enableLog;
+        bool m_backgroundPending; //!< True until the result of the command sent with commandInBackground() is received.
+        GdbResult m_backgroundResult;
+        Tree m_backgroundResultData;
+        QEventLoop *m_backgroundLoop; //!< Runs while commandInBackground() waits for the result.
 };
 
 
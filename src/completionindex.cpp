@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2018 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "completionindex.h"
+
+#include <QElapsedTimer>
+#include <QPair>
+#include <algorithm>
+
+
+// Scores used by the fuzzy matcher (same idea as fzf)
+#define SCORE_MATCH             16
+#define SCORE_GAP_START         -3
+#define SCORE_GAP_EXTENSION     -1
+#define BONUS_BOUNDARY_START    10  // Match on first character
+#define BONUS_BOUNDARY          8   // Match after '_', ':', '/', ...
+#define BONUS_CAMEL             7   // Match on "fooBar" or "foo2"
+#define BONUS_CONSECUTIVE       4
+#define BONUS_FIRST_CHAR_MULTIPLIER 2
+
+
+struct Match
+{
+    int m_score;
+    int m_idx;
+    int m_length;
+};
+
+static bool matchLessThan(const Match &a, const Match &b)
+{
+    if(a.m_score != b.m_score)
+        return a.m_score > b.m_score;
+    if(a.m_length != b.m_length)
+        return a.m_length < b.m_length;
+    return a.m_idx < b.m_idx;
+}
+
+
+CompletionIndex::CompletionIndex()
+    : m_lastComplete(false)
+{
+}
+
+CompletionIndex::~CompletionIndex()
+{
+}
+
+
+void CompletionIndex::clear()
+{
+    m_list.clear();
+    m_lowerList.clear();
+    m_lastPattern.clear();
+    m_lastMatches.clear();
+    m_lastComplete = false;
+}
+
+
+/**
+ * @brief Sets the strings to search (duplicates are removed).
+ */
+void CompletionIndex::setList(QStringList list)
+{
+    clear();
+
+    QVector<QPair<QString, QString> > pairList;
+    pairList.reserve(list.size());
+    for(int i = 0;i < list.size();i++)
+        pairList.append(qMakePair(list[i].toLower(), list[i]));
+    std::sort(pairList.begin(), pairList.end());
+
+    for(int i = 0;i < pairList.size();i++)
+    {
+        if(i > 0 && pairList[i].second == pairList[i-1].second)
+            continue;
+        m_lowerList.append(pairList[i].first);
+        m_list.append(pairList[i].second);
+    }
+}
+
+
+/**
+ * @brief Finds the range of strings starting with a prefix.
+ */
+void CompletionIndex::findPrefixRange(QString lowerPrefix, int *startIdx, int *endIdx) const
+{
+    QStringList::const_iterator startIt = std::lower_bound(m_lowerList.begin(), m_lowerList.end(), lowerPrefix);
+    QStringList::const_iterator endIt = std::lower_bound(startIt, m_lowerList.end(), lowerPrefix + QChar(0xffff));
+    *startIdx = startIt - m_lowerList.begin();
+    *endIdx = endIt - m_lowerList.begin();
+}
+
+
+static inline bool isCharMatch(QChar textChar, QChar patternChar, bool caseSensitive)
+{
+    if(caseSensitive)
+        return textChar == patternChar;
+    return textChar.toLower() == patternChar;
+}
+
+
+/**
+ * @brief Returns the bonus for matching the character at a position.
+ */
+static int getCharBonus(const QString &text, int idx)
+{
+    if(idx == 0)
+        return BONUS_BOUNDARY_START;
+    QChar prevChar = text[idx-1];
+    QChar c = text[idx];
+    if(!prevChar.isLetterOrNumber())
+        return BONUS_BOUNDARY;
+    if(prevChar.isLower() && c.isUpper())
+        return BONUS_CAMEL;
+    if(!prevChar.isDigit() && c.isDigit())
+        return BONUS_CAMEL;
+    return 0;
+}
+
+
+/**
+ * @brief Checks if all characters in a pattern occurs in order in a text.
+ *
+ * Consecutive matches and matches at the start of words gives a higher score.
+ * @param pattern         The pattern. Must be lowercase if caseSensitive is false.
+ * @return -1 if the pattern does not match. Otherwise the score (>= 0).
+ */
+int CompletionIndex::fuzzyScore(const QString &pattern, const QString &text, bool caseSensitive)
+{
+    const int patternLen = pattern.size();
+    const int textLen = text.size();
+    if(patternLen == 0)
+        return 0;
+
+    // Find the first position where the whole pattern has been matched
+    int pi = 0;
+    int endIdx = -1;
+    for(int ti = 0;ti < textLen;ti++)
+    {
+        if(isCharMatch(text[ti], pattern[pi], caseSensitive))
+        {
+            pi++;
+            if(pi == patternLen)
+            {
+                endIdx = ti;
+                break;
+            }
+        }
+    }
+    if(endIdx == -1)
+        return -1;
+
+    // Go backwards to find the shortest match ending there
+    int startIdx = endIdx;
+    pi = patternLen-1;
+    for(int ti = endIdx;ti >= 0;ti--)
+    {
+        if(isCharMatch(text[ti], pattern[pi], caseSensitive))
+        {
+            if(pi == 0)
+            {
+                startIdx = ti;
+                break;
+            }
+            pi--;
+        }
+    }
+
+    // Calculate the score
+    int score = 0;
+    int prevMatchIdx = -2;
+    bool inGap = false;
+    pi = 0;
+    for(int ti = startIdx;ti <= endIdx;ti++)
+    {
+        if(pi < patternLen && isCharMatch(text[ti], pattern[pi], caseSensitive))
+        {
+            int bonus = getCharBonus(text, ti);
+            if(prevMatchIdx == ti-1)
+                bonus = qMax(bonus, BONUS_CONSECUTIVE);
+            if(pi == 0)
+                bonus *= BONUS_FIRST_CHAR_MULTIPLIER;
+            score += SCORE_MATCH + bonus;
+            prevMatchIdx = ti;
+            inGap = false;
+            pi++;
+        }
+        else
+        {
+            score += inGap ? SCORE_GAP_EXTENSION : SCORE_GAP_START;
+            inGap = true;
+        }
+    }
+    return qMax(score, 0);
+}
+
+
+/**
+ * @brief Returns the best matching strings.
+ *
+ * Strings starting with the pattern are checked first. If there are more
+ * than maxCount of those the rest of the strings are not checked at all.
+ * @param pattern         The text entered by the user. Case sensitive if it contains uppercase characters.
+ * @param maxCount        Max number of strings to return.
+ * @param timeBudgetMs    Stop searching after this time (-1 for no limit).
+ */
+QStringList CompletionIndex::find(QString pattern, int maxCount, int timeBudgetMs)
+{
+    QStringList resultList;
+
+    if(pattern.isEmpty())
+    {
+        m_lastPattern.clear();
+        m_lastComplete = false;
+        return m_list.mid(0, maxCount);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString lowerPattern = pattern.toLower();
+    bool caseSensitive = (pattern != lowerPattern);
+    QString searchPattern = caseSensitive ? pattern : lowerPattern;
+
+    int prefixStartIdx;
+    int prefixEndIdx;
+    findPrefixRange(lowerPattern, &prefixStartIdx, &prefixEndIdx);
+
+    QVector<Match> matchList;
+    bool complete = true;
+
+    // Check the strings that starts with the pattern first
+    for(int idx = prefixStartIdx;idx < prefixEndIdx;idx++)
+    {
+        int score = fuzzyScore(searchPattern, m_list[idx], caseSensitive);
+        if(score >= 0)
+        {
+            Match m = {score, idx, m_list[idx].size()};
+            matchList.append(m);
+        }
+    }
+
+    if(prefixEndIdx-prefixStartIdx >= maxCount)
+        complete = false;
+    else
+    {
+        // Can we just look at the matches of the last search?
+        bool narrowing = m_lastComplete && pattern.startsWith(m_lastPattern);
+        int candidateCount = narrowing ? m_lastMatches.size() : m_list.size();
+        for(int i = 0;i < candidateCount;i++)
+        {
+            if(timeBudgetMs >= 0 && (i & 0xff) == 0 && timer.elapsed() > timeBudgetMs)
+            {
+                complete = false;
+                break;
+            }
+            
+            int idx = narrowing ? m_lastMatches[i] : i;
+            if(prefixStartIdx <= idx && idx < prefixEndIdx)
+                continue;
+            int score = fuzzyScore(searchPattern, m_list[idx], caseSensitive);
+            if(score >= 0)
+            {
+                Match m = {score, idx, m_list[idx].size()};
+                matchList.append(m);
+            }
+        }
+    }
+
+    // Remember the result to speed up the next search
+    m_lastPattern = pattern;
+    m_lastComplete = complete;
+    m_lastMatches.clear();
+    if(complete)
+    {
+        m_lastMatches.reserve(matchList.size());
+        for(int i = 0;i < matchList.size();i++)
+            m_lastMatches.append(matchList[i].m_idx);
+    }
+
+    // Get the best ones
+    int resultCount = qMin(maxCount, matchList.size());
+    std::partial_sort(matchList.begin(), matchList.begin()+resultCount, matchList.end(), matchLessThan);
+    for(int i = 0;i < resultCount;i++)
+        resultList.append(m_list[matchList[i].m_idx]);
+
+    return resultList;
+}
+
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2018 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__COMPLETIONINDEX_H
+#define FILE__COMPLETIONINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+
+/**
+ * @brief Sorted list of strings that can be searched by prefix or by a fuzzy pattern.
+ *
+ * The result of the last search is remembered so that a search with a
+ * pattern that extends the previous one only has to look at the
+ * previous matches.
+ */
+class CompletionIndex
+{
+public:
+    CompletionIndex();
+    virtual ~CompletionIndex();
+
+    void setList(QStringList list);
+    void clear();
+    int size() const { return m_list.size(); };
+
+    QStringList find(QString pattern, int maxCount, int timeBudgetMs = -1);
+
+    static int fuzzyScore(const QString &pattern, const QString &text, bool caseSensitive);
+
+private:
+    void findPrefixRange(QString lowerPrefix, int *startIdx, int *endIdx) const;
+
+private:
+    QStringList m_list; //!< Sorted case insensitive
+    QStringList m_lowerList; //!< m_list in lowercase
+
+    // Result of the last search
+    QString m_lastPattern;
+    QVector<int> m_lastMatches;
+    bool m_lastComplete;
+};
+
+
+#endif // FILE__COMPLETIONINDEX_H
@@ -19,19 +19,69 @@
 
 #define GDB_LOG_FILE  "gede_gdb_log.txt"
 
+// Directory (in the project directory) where gdb caches the symbol indexes
+#define GDB_INDEX_CACHE_DIR  ".gede2_index_cache"
+
 // etags command and argument to use to get list of tags
 #define ETAGS_CMD1     "ctags"    // Used on Linux
 #define ETAGS_CMD2     "exctags"  // Used on freebsd
 #define ETAGS_ARGS    " -f - --excmd=number --fields=+nmsSk --langmap=c++:+.ino"
 
+// Max number of files to pass to a single ctags process
+#define ETAGS_BATCH_SIZE    200
+
+
+// Time (in milliseconds) to wait after a breakpoint change before saving the breakpoints
+#define BREAKPOINT_SAVE_DELAY   500
+
+
+// Max number of entries in the watchpoint log (the oldest are removed)
+#define WATCHPOINT_LOG_SIZE     1000
+
+// Number of stack frames to fetch at a time when the stack view is scrolled
+#define STACK_FRAME_FETCH_COUNT 100
+
+// Max number of stack frames to show (protects against corrupted stacks)
+#define STACK_MAX_DEPTH         100000
+
+// Max number of stack frames to show for each thread in the thread list
+#define THREAD_MAX_FRAME_COUNT  100
+
+// Max number of steps to take when stepping until a expression is true
+#define STEP_UNTIL_MAX_COUNT    100000
+
 
 // Max number of recently used goto locations to save
 #define MAX_GOTO_RUI_COUNT  10
 
+// Max number of suggestions to show in the GoTo dialog
+#define GOTO_MAX_SUGGESTIONS    200
+
+// Max time (in milliseconds) to search for suggestions in the GoTo dialog
+#define GOTO_SEARCH_TIME_LIMIT  20
+
+// Min time (in milliseconds) between rebuilding the suggestions in the GoTo dialog while tags are added
+#define GOTO_INDEX_UPDATE_INTERVAL  2000
+
+// Number of symbols to show per page in the symbol search panel
+#define SYMBOL_SEARCH_PAGE_SIZE 100
+
+// Time (in milliseconds) to wait after a keypress before searching for symbols
+#define SYMBOL_SEARCH_DELAY     150
+
 // Width of items in the GoTo list widget.
 #define GOTO_LISTWIDGET_ITEM_WIDTH  240
 
 
+// Time (in milliseconds) to wait after a keypress before filtering the class/function list
+#define TAG_FILTER_DELAY        150
+
+// Number of names to match before showing the result in the class/function list
+#define TAG_FILTER_CHUNK_SIZE   5000
+
+// Max number of filter patterns to remember the result of
+#define TAG_FILTER_CACHE_SIZE   16
+
 // Expand all classes if the total number of members is below this number
 #define CLASS_LIST_AUTO_EXPAND_COUNT 40
 
@@ -13,6 +13,7 @@
 #include <QByteArray>
 #include <QDebug>
 #include <QFileInfo>
+#include <QDir>
 
 #include <unistd.h>
 #include <assert.h>
@@ -24,11 +25,13 @@
 #include <sys/ioctl.h>
 #include <string.h>
 #include <errno.h>
+#include <algorithm>
 
 #include "ini.h"
 #include "util.h"
 #include "log.h"
 #include "gdbmiparser.h"
+#include "config.h"
 
 
 VarWatch::VarWatch()
@@ -237,6 +240,10 @@ Core::Core()
     ,m_isRemote(false)
     ,m_ptsFd(0)
     ,m_scanSources(false)
+    ,m_visiblePanels(PANEL_ALL)
+    ,m_stalePanels(0)
+    ,m_batchMode(BATCH_NONE)
+    ,m_batchCount(0)
     ,m_ptsListener(NULL)
     ,m_memDepth(32)
 {
@@ -312,6 +319,24 @@ void Core::detectMemoryDepth()
 
 
 
+/**
+ * @brief Sends a command that loads the symbols of the program.
+ *
+ * If the symbols should be loaded in the background the gui keeps
+ * processing events while gdb loads them.
+ * @return The result (GDB_EXIT if the application quit while loading).
+ */
+GdbResult Core::loadSymbols(Settings *cfg, QString cmd)
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    if(cfg->m_loadSymbolsInBackground)
+        return com.commandInBackground(&resultData, cmd);
+    return com.command(&resultData, cmd);
+}
+
+
 /**
  * @brief Connects to a running program (with a specific PID).
  */
@@ -323,7 +348,7 @@ int Core::initPid(Settings *cfg, QString gdbPath, QString programPath, int pid)
 
     m_isRemote = false;
 
-    if(com.init(gdbPath, cfg->m_enableDebugLog))
+    if(com.init(gdbPath, cfg->m_enableDebugLog, getEarlyInitCommands(cfg)))
     {
         critMsg("Failed to start gdb ('%s')", stringToCStr(gdbPath));
         return -1;
@@ -337,7 +362,10 @@ int Core::initPid(Settings *cfg, QString gdbPath, QString programPath, int pid)
         critMsg("Failed to set inferior tty");
     }
 
-    if(com.commandF(&resultData, "-file-exec-and-symbols %s", stringToCStr(programPath)) == GDB_ERROR)
+    GdbResult loadRes = loadSymbols(cfg, "-file-exec-and-symbols " + programPath);
+    if(loadRes == GDB_EXIT)
+        return -1;
+    if(loadRes == GDB_ERROR)
     {
         critMsg("Failed to load '%s'", stringToCStr(programPath));
     }
@@ -360,12 +388,40 @@ int Core::initPid(Settings *cfg, QString gdbPath, QString programPath, int pid)
 
     runInitCommands(cfg);
 
-    gdbGetFiles();
+    gdbGetFiles(NULL, NULL, cfg->m_loadSymbolsInBackground);
 
     return rc;
 }
 
 
+/**
+ * @brief Returns the commands to pass to gdb before it loads the program.
+ *
+ * Makes gdb keep a cache of the symbol indexes in the project directory
+ * so that the symbols loads faster the next time. Debuginfod is disabled
+ * to make sure that gdb never tries to access the network.
+ */
+QStringList Core::getEarlyInitCommands(Settings *cfg)
+{
+    QStringList cmdList;
+
+    cmdList.append("set debuginfod enabled off");
+
+    if(cfg->m_useIndexCache)
+    {
+        QString projDir = cfg->getProjectDir();
+        if(projDir.isEmpty())
+            projDir = QDir::currentPath();
+        cmdList.append("set index-cache directory " + projDir + "/" + GDB_INDEX_CACHE_DIR);
+
+        // "enabled on" is used by gdb 12 and later and "on" by older versions
+        cmdList.append("set index-cache enabled on");
+        cmdList.append("set index-cache on");
+    }
+    return cmdList;
+}
+
+
 /**
  * @brief Execute the init commands (supplied by the user).
  */
@@ -399,7 +455,7 @@ int Core::initLocal(Settings *cfg, QString gdbPath, QString programPath, QString
 
     m_isRemote = false;
 
-    if(com.init(gdbPath, cfg->m_enableDebugLog))
+    if(com.init(gdbPath, cfg->m_enableDebugLog, getEarlyInitCommands(cfg)))
     {
         critMsg("Failed to start gdb ('%s')", stringToCStr(gdbPath));
         return -1;
@@ -413,7 +469,10 @@ int Core::initLocal(Settings *cfg, QString gdbPath, QString programPath, QString
         critMsg("Failed to set inferior tty");
     }
 
-    if(com.commandF(&resultData, "-file-exec-and-symbols %s", stringToCStr(programPath)) == GDB_ERROR)
+    GdbResult loadRes = loadSymbols(cfg, "-file-exec-and-symbols " + programPath);
+    if(loadRes == GDB_EXIT)
+        return -1;
+    if(loadRes == GDB_ERROR)
     {
         critMsg("Failed to load '%s'", stringToCStr(programPath));
     }
@@ -440,7 +499,7 @@ int Core::initLocal(Settings *cfg, QString gdbPath, QString programPath, QString
     }
 
 
-    gdbGetFiles();
+    gdbGetFiles(NULL, NULL, cfg->m_loadSymbolsInBackground);
 
     return rc;
 }
@@ -459,7 +518,7 @@ int Core::initCoreDump(Settings *cfg, QString gdbPath, QString programPath, QStr
     m_isRemote = false;
 
 
-    if(com.init(gdbPath, cfg->m_enableDebugLog))
+    if(com.init(gdbPath, cfg->m_enableDebugLog, getEarlyInitCommands(cfg)))
     {
         critMsg("Failed to start gdb ('%s')", stringToCStr(gdbPath));
         return -1;
@@ -468,7 +527,8 @@ int Core::initCoreDump(Settings *cfg, QString gdbPath, QString programPath, QStr
     // Load the symbols
     if(!programPath.isEmpty())
     {
-        com.commandF(&resultData, "-file-exec-and-symbols %s", stringToCStr(programPath));
+        if(loadSymbols(cfg, "-file-exec-and-symbols " + programPath) == GDB_EXIT)
+            return -1;
     }
 
     // Load the coredump file
@@ -489,7 +549,7 @@ int Core::initCoreDump(Settings *cfg, QString gdbPath, QString programPath, QStr
 
     runInitCommands(cfg);
 
-    gdbGetFiles();
+    gdbGetFiles(NULL, NULL, cfg->m_loadSymbolsInBackground);
 
     m_targetState = ICore::TARGET_FINISHED;
     if(m_inf)
@@ -510,7 +570,7 @@ int Core::initRemote(Settings *cfg, QString gdbPath, QString programPath, QStrin
 
     m_isRemote = true;
     
-    if(com.init(gdbPath, cfg->m_enableDebugLog))
+    if(com.init(gdbPath, cfg->m_enableDebugLog, getEarlyInitCommands(cfg)))
     {
         critMsg("Failed to start gdb ('%s')", stringToCStr(gdbPath));
         return -1;
@@ -518,8 +578,8 @@ int Core::initRemote(Settings *cfg, QString gdbPath, QString programPath, QStrin
 
     if(!programPath.isEmpty())
     {
-        com.commandF(&resultData, "-file-symbol-file %s", stringToCStr(programPath));
-
+        if(loadSymbols(cfg, "-file-symbol-file " + programPath) == GDB_EXIT)
+            return -1;
     }
 
     if(!programPath.isEmpty())
@@ -546,7 +606,7 @@ int Core::initRemote(Settings *cfg, QString gdbPath, QString programPath, QStrin
         warnMsg("Failed to set breakpoint at %s", stringToCStr(cfg->m_initialBreakpoint));
     }
 
-    gdbGetFiles();
+    gdbGetFiles(NULL, NULL, cfg->m_loadSymbolsInBackground);
 
     
     return 0;
@@ -562,7 +622,7 @@ int Core::initSerial(Settings *cfg, QString gdbPath, QString programPath, QStrin
     m_isRemote = true;
 
 
-    if(com.init(gdbPath, cfg->m_enableDebugLog))
+    if(com.init(gdbPath, cfg->m_enableDebugLog, getEarlyInitCommands(cfg)))
     {
         critMsg("Failed to start gdb ('%s')", stringToCStr(gdbPath));
         return -1;
@@ -572,8 +632,8 @@ int Core::initSerial(Settings *cfg, QString gdbPath, QString programPath, QStrin
 
     if(!programPath.isEmpty())
     {
-        com.commandF(&resultData, "-file-symbol-file %s", stringToCStr(programPath));
-
+        if(loadSymbols(cfg, "-file-symbol-file " + programPath) == GDB_EXIT)
+            return -1;
     }
 
     if(!programPath.isEmpty())
@@ -599,7 +659,7 @@ int Core::initSerial(Settings *cfg, QString gdbPath, QString programPath, QStrin
         warnMsg("Failed to set breakpoint at %s", stringToCStr(cfg->m_initialBreakpoint));
     }
 
-    gdbGetFiles();
+    gdbGetFiles(NULL, NULL, cfg->m_loadSymbolsInBackground);
 
     
     return 0;
@@ -697,27 +757,32 @@ void Core::gdbManualCommand(QString cmd)
 
 /**
 * @brief Asks GDB for a list of source files.
+*
+* The files already in the list are kept. Only the files that has been
+* added or removed are changed.
+* @param addedList     Receives the full path of the new files.
+* @param removedList   Receives the full path of the files that has been removed.
+* @param inBackground  True if the gui should be kept responsive while gdb lists the files.
 * @return true if any files was added or removed.
 */
-bool Core::gdbGetFiles()
+bool Core::gdbGetFiles(QStringList *addedList, QStringList *removedList, bool inBackground)
 {
     GdbCom& com = GdbCom::getInstance();
     Tree resultData;
-    QMap<QString, bool> fileLookup;
     bool modified = false;
+    GdbResult res;
     
-    com.command(&resultData, "-file-list-exec-source-files");
-
-
-    // Clear the old list
-    for(int m = 0;m < m_sourceFiles.size();m++)
-    {
-        SourceFile *sourceFile = m_sourceFiles[m];
-        fileLookup[sourceFile->m_fullName] = false;
-        delete sourceFile;
-    }
-    m_sourceFiles.clear();
+    // (Listing the files makes gdb expand all the symbols which is slow for a huge program)
+    if(inBackground)
+        res = com.commandInBackground(&resultData, "-file-list-exec-source-files");
+    else
+        res = com.command(&resultData, "-file-list-exec-source-files");
+    if(res == GDB_ERROR || res == GDB_EXIT)
+        return false;
 
+    QHash<QString, SourceFile*> oldLookup = m_sourceFileLookup;
+    QVector<SourceFile*> newList;
+    QHash<QString, SourceFile*> newLookup;
 
     // Create the new list
     for(int k = 0;k < resultData.getRootChildCount();k++)
@@ -733,47 +798,44 @@ bool Core::gdbGetFiles()
                 QString name = childNode->getChildDataString("file");
                 QString fullname = childNode->getChildDataString("fullname");
 
-                if(fullname.isEmpty())
+                if(fullname.isEmpty() || name.contains("<built-in>"))
+                    continue;
+
+                // Already added this file?
+                if(newLookup.contains(fullname))
                     continue;
 
-                SourceFile *sourceFile = NULL;
-                if(!name.contains("<built-in>"))
+                SourceFile *sourceFile = oldLookup.take(fullname);
+                if(sourceFile == NULL)
                 {
-                    // Already added this file?
-                    bool alreadyAdded = false;
-                    if(fileLookup.contains(fullname))
-                    {
-                        if(fileLookup[fullname] == true)
-                            alreadyAdded = true;
-                    }
-                    else
-                        modified = true;
-                        
-                    if(!alreadyAdded)
-                    {
-                        fileLookup[fullname] = true;
-                        
-                        sourceFile = new SourceFile; 
+                    sourceFile = new SourceFile; 
 
-                        sourceFile->m_name = name;
-                        sourceFile->m_fullName = fullname;
-                        sourceFile->m_modTime = QDateTime::currentDateTime();
+                    sourceFile->m_name = name;
+                    sourceFile->m_fullName = fullname;
+                    sourceFile->m_modTime = QDateTime::currentDateTime();
 
-                        m_sourceFiles.append(sourceFile);
-                    }
+                    if(addedList)
+                        addedList->append(fullname);
+                    modified = true;
                 }
-                
+                newList.append(sourceFile);
+                newLookup[fullname] = sourceFile;
             }
         }
     }
 
     // Any file removed?
-    QMap<QString, bool> ::const_iterator iterFl = fileLookup.constBegin();
-    while (iterFl != fileLookup.constEnd()) {
-        if(iterFl.value() == false)
-            modified = false;
-        ++iterFl;
+    QHash<QString, SourceFile*>::const_iterator iter;
+    for(iter = oldLookup.constBegin();iter != oldLookup.constEnd();++iter)
+    {
+        if(removedList)
+            removedList->append(iter.key());
+        delete iter.value();
+        modified = true;
     }
+
+    m_sourceFiles = newList;
+    m_sourceFileLookup = newLookup;
     
     return modified;
 }
@@ -817,6 +879,12 @@ void Core::gdbRun()
             m_inf->ICore_onMessage("Program is currently running");
         return;
     }
+    if(com.isBackgroundCommandPending())
+    {
+        if(m_inf)
+            m_inf->ICore_onMessage("Program is being loaded");
+        return;
+    }
 
     //
     if(m_ptsListener)
@@ -847,13 +915,17 @@ void Core::gdbRun()
                 QDateTime modTime = QFileInfo(sourceFile->m_fullName).lastModified();
                 if(sourceFile->m_modTime <  modTime)
                 {
+                    sourceFile->m_modTime = modTime;
                     m_inf->ICore_onSourceFileChanged(sourceFile->m_fullName);
                 }
             }
         }
 
-        // Get all source files
-        gdbGetFiles();
+        // Get the source files that has been added or removed
+        QStringList addedList;
+        QStringList removedList;
+        if(gdbGetFiles(&addedList, &removedList))
+            m_inf->ICore_onSourceFilesUpdated(addedList, removedList);
                                 
     }
 }
@@ -991,14 +1063,51 @@ int Core::jump(QString filename, int lineNo)
 
 
 /**
- * @brief Request a list of stack frames.
+ * @brief Returns the commands that updates a set of panels.
+ * @param panels   The panels (PANEL_*) to update.
  */
-void Core::getStackFrames()
+QStringList Core::getPanelQueries(int panels)
 {
-    GdbCom& com = GdbCom::getInstance();
-    Tree resultData;
-    com.command(&resultData, "-stack-list-frames");
+    QStringList cmdList;
+
+    // Any new or destroyed thread?
+    if(panels & PANEL_THREADS)
+        cmdList.append("-thread-info");
+    if(panels & (PANEL_WATCH | PANEL_AUTO))
+        cmdList.append("-var-update --all-values *");
+    if(panels & PANEL_AUTO)
+        cmdList.append("-stack-list-variables --no-values");
+    if(panels & PANEL_STACK)
+        cmdList.append(QString("-stack-info-depth %1").arg(STACK_MAX_DEPTH));
+    return cmdList;
+}
+
+
+/**
+ * @brief Tells if a panel is shown or not.
+ *
+ * A panel that is shown after the program has stopped is updated directly.
+ */
+void Core::setPanelVisible(Panel panel, bool visible)
+{
+    if(!visible)
+    {
+        m_visiblePanels &= ~panel;
+        return;
+    }
+    m_visiblePanels |= panel;
 
+    if((m_stalePanels & panel) && m_targetState == ICore::TARGET_STOPPED)
+    {
+        m_stalePanels &= ~panel;
+
+        GdbCom& com = GdbCom::getInstance();
+        com.commandBatch(getPanelQueries(panel), QList<Tree*>());
+
+        // Select the current frame in the new stack list
+        if(panel == PANEL_STACK && m_inf)
+            m_inf->ICore_onCurrentFrameChanged(m_currentFrameIdx);
+    }
 }
 
 
@@ -1135,26 +1244,26 @@ int Core::priv_gdbVarWatchCreate(QString varName, QString watchId, VarWatch* wat
         rc = -1;
     }
     else
-    {
+        parseVarCreateResult(watch, resultData);
 
-    //
-    QString varName2 = resultData.getString("name");
+
+    return rc;
+
+}
+
+
+/**
+ * @brief Fills in a watch from the result of -var-create.
+ */
+void Core::parseVarCreateResult(VarWatch *watch, Tree &resultData)
+{
     QString varValue2 = resultData.getString("value");
     QString varType2 = resultData.getString("type");
     int numChild = resultData.getInt("numchild", 0);
 
-
-    // debugMsg("%s = %s = %s\n", stringToCStr(varName2),stringToCStr(varValue2), stringToCStr(varType2));
-
     watch->m_varType = varType2;
     watch->setValue(varValue2);
     watch->m_hasChildren = numChild > 0 ? true : false;
-        
-    }
-
-
-    return rc;
-
 }
 
 
@@ -1186,6 +1295,110 @@ int Core::gdbAddVarWatch(QString varName, VarWatch** watchPtr)
 }
 
 
+/**
+ * @brief Adds watches for a list of variables with one pipelined batch of commands.
+ *
+ * The watches are bound to the selected frame.
+ * @return The watches (NULL for the variables that could not be watched).
+ */
+QList<VarWatch*> Core::gdbAddVarWatches(QStringList varNames)
+{
+    GdbCom& com = GdbCom::getInstance();
+    QList<VarWatch*> watchList;
+    QStringList cmdList;
+    QList<Tree*> resultDataList;
+
+    for(int i = 0;i < varNames.size();i++)
+    {
+        QString watchId = QString::asprintf("w%d", m_varWatchLastId++);
+        watchList.append(new VarWatch(watchId, varNames[i]));
+        cmdList.append(QString("-var-create %1 * %2").arg(watchId).arg(varNames[i]));
+        resultDataList.append(new Tree);
+    }
+    if(cmdList.isEmpty())
+        return watchList;
+
+    QVector<GdbResult> resultList = com.commandBatch(cmdList, resultDataList);
+    for(int i = 0;i < watchList.size();i++)
+    {
+        if(resultList[i] == GDB_ERROR)
+        {
+            delete watchList[i];
+            watchList[i] = NULL;
+        }
+        else
+        {
+            parseVarCreateResult(watchList[i], *resultDataList[i]);
+            m_watchList.append(watchList[i]);
+        }
+    }
+    qDeleteAll(resultDataList);
+
+    return watchList;
+}
+
+
+/**
+ * @brief Returns the watches for the auto variables of the selected frame.
+ *
+ * The watches are created the first time the frame is shown and are
+ * reused when the frame is selected again until the program resumes.
+ * @return The watches (NULL for the variables that could not be watched).
+ */
+QList<VarWatch*> Core::gdbGetFrameVarWatches(QStringList varNames)
+{
+    QList<VarWatch*> watchList;
+
+    // Delete the watches of the frames from before the program was resumed
+    // (They may already have been removed by -var-update)
+    for(int i = 0;i < m_staleFrameWatches.size();i++)
+    {
+        QString watchId = m_staleFrameWatches[i];
+        if(!watchId.isEmpty() && getVarWatchInfo(watchId))
+            gdbRemoveVarWatch(watchId);
+    }
+    m_staleFrameWatches.clear();
+
+    // Already shown since the program stopped?
+    QPair<int,int> key(m_selectedThreadId, m_currentFrameIdx);
+    if(m_frameWatchCache.contains(key))
+    {
+        QStringList watchIdList = m_frameWatchCache.take(key);
+        bool isValid = (watchIdList.size() == varNames.size());
+        for(int i = 0;isValid && i < watchIdList.size();i++)
+        {
+            VarWatch *watch = NULL;
+            if(!watchIdList[i].isEmpty())
+            {
+                watch = getVarWatchInfo(watchIdList[i]);
+                if(watch == NULL || watch->getName() != varNames[i])
+                    isValid = false;
+            }
+            watchList.append(watch);
+        }
+        if(isValid)
+        {
+            m_frameWatchCache[key] = watchIdList;
+            return watchList;
+        }
+
+        watchList.clear();
+        for(int i = 0;i < watchIdList.size();i++)
+        {
+            if(!watchIdList[i].isEmpty() && getVarWatchInfo(watchIdList[i]))
+                gdbRemoveVarWatch(watchIdList[i]);
+        }
+    }
+
+    watchList = gdbAddVarWatches(varNames);
+    QStringList watchIdList;
+    for(int i = 0;i < watchList.size();i++)
+        watchIdList.append(watchList[i] ? watchList[i]->getWatchId() : QString());
+    m_frameWatchCache[key] = watchIdList;
+    return watchList;
+}
+
+
 /**
  * @brief Expands all the children of a watched variable.
  * @return 0 on success.
@@ -1315,7 +1528,7 @@ void Core::onNotifyAsyncOut(Tree &tree, AsyncClass ac)
         int id = tree.getInt("id");
         dispatchBreakpointDeleted(id);
     }
-    else if(ac == GdbComListener::AC_BREAKPOINT_MODIFIED)
+    else if(ac == GdbComListener::AC_BREAKPOINT_CREATED || ac == GdbComListener::AC_BREAKPOINT_MODIFIED)
     {
         for(int i = 0;i < tree.getRootChildCount();i++)
         {
@@ -1331,10 +1544,27 @@ void Core::onNotifyAsyncOut(Tree &tree, AsyncClass ac)
     // A new thread has been created
     else if(ac == GdbComListener::AC_THREAD_CREATED)
     {
-        gdbGetThreadList();
-        
+        // The name and details are filled in by the next -thread-info
+        ThreadInfo tinfo;
+        tinfo.m_id = tree.getInt("id");
+        if(!m_threadList.contains(tinfo.m_id))
+        {
+            m_threadList[tinfo.m_id] = tinfo;
+            if(m_inf)
+                m_inf->ICore_onThreadAdded(tinfo);
+        }
+    }
+    else if(ac == GdbComListener::AC_THREAD_EXITED)
+    {
+        int threadId = tree.getInt("id");
+        if(m_threadList.remove(threadId) > 0)
+        {
+            if(m_inf)
+                m_inf->ICore_onThreadRemoved(threadId);
+        }
     }
-    else if(ac == GdbComListener::AC_LIBRARY_LOADED)
+    else if(ac == GdbComListener::AC_LIBRARY_LOADED ||
+            ac == GdbComListener::AC_LIBRARY_UNLOADED)
     {
         m_scanSources = true;
     }
@@ -1356,9 +1586,14 @@ ICore::StopReason Core::parseReasonString(QString reasonString)
         return ICore::FUNCTION_FINISHED;
     if(reasonString == "exited")
         return ICore::EXITED;
+    if(reasonString == "watchpoint-trigger" ||
+        reasonString == "read-watchpoint-trigger" ||
+        reasonString == "access-watchpoint-trigger")
+        return ICore::WATCHPOINT_TRIGGER;
+    if(reasonString == "watchpoint-scope")
+        return ICore::WATCHPOINT_SCOPE;
     
-    errorMsg("Received unknown reason (\"%s\").", stringToCStr(reasonString));
-    assert(0);
+    warnMsg("Received unknown reason (\"%s\").", stringToCStr(reasonString));
 
     return ICore::UNKNOWN;
 }
@@ -1375,22 +1610,49 @@ void Core::onExecAsyncOut(Tree &tree, AsyncClass ac)
     // The program has stopped
     if(ac == GdbComListener::AC_STOPPED)
     {
+        // A watchpoint that should only be logged?
+        QString reasonString = tree.getString("reason");
+        ICore::StopReason  reason = ICore::UNKNOWN;
+        if(!reasonString.isEmpty())
+            reason = parseReasonString(reasonString);
+        if(reason == ICore::WATCHPOINT_TRIGGER || reason == ICore::WATCHPOINT_SCOPE)
+        {
+            if(dispatchWatchPointTrigger(tree, reason))
+            {
+                com.command(NULL, "-exec-continue");
+                return;
+            }
+        }
+
+        // Take the next step of a batch without updating the gui
+        if(m_batchMode != BATCH_NONE && continueBatch(reason))
+            return;
+
         m_targetState = ICore::TARGET_STOPPED;
 
-        if(m_pid == 0)
-            com.command(NULL, "-list-thread-groups");
-         
-        // Any new or destroyed thread?
-        com.commandF(NULL, "-thread-info");
+        // The thread and frame that stopped is selected
+        m_currentFrameIdx = tree.getInt("frame/level");
+        QString stopThreadIdStr = tree.getString("thread-id");
+        if(!stopThreadIdStr.isEmpty())
+            m_selectedThreadId = stopThreadIdStr.toInt(0,0);
 
-        com.commandF(NULL, "-var-update --all-values *");
-        com.commandF(NULL, "-stack-list-variables --no-values");
+        // Only update the panels that are shown (the others are updated when they are shown)
+        QStringList cmdList;
+        if(m_pid == 0)
+            cmdList.append("-list-thread-groups");
+        cmdList += getPanelQueries(m_visiblePanels);
+        m_stalePanels = PANEL_ALL & ~m_visiblePanels;
+        if((m_stalePanels & PANEL_STACK) && m_inf)
+            m_inf->ICore_onStackDepthChanged(0);
+        com.commandBatch(cmdList, QList<Tree*>());
 
         if(m_scanSources)
         {
-            if(gdbGetFiles())
+            QStringList addedList;
+            QStringList removedList;
+            if(gdbGetFiles(&addedList, &removedList))
             {
-                m_inf->ICore_onSourceFileListChanged();
+                m_inf->ICore_onSourceFilesUpdated(addedList, removedList);
             }
             m_scanSources = false;
         }
@@ -1398,14 +1660,6 @@ void Core::onExecAsyncOut(Tree &tree, AsyncClass ac)
         
 
 
-        // Get the reason
-        QString reasonString = tree.getString("reason");
-        ICore::StopReason  reason;
-        if(reasonString.isEmpty())
-            reason = ICore::UNKNOWN;
-        else
-            reason = parseReasonString(reasonString);
-
         if(reason == ICore::EXITED_NORMALLY || reason == ICore::EXITED)
         {
             m_targetState = ICore::TARGET_FINISHED;
@@ -1456,17 +1710,41 @@ void Core::onExecAsyncOut(Tree &tree, AsyncClass ac)
             m_inf->ICore_onCurrentFrameChanged(frameIdx);
 
         }
+
+        // Remember the variables of the frame so that selecting it again is instant
+        if(m_targetState == ICore::TARGET_STOPPED && (m_visiblePanels & PANEL_AUTO))
+        {
+            FrameVars vars;
+            vars.m_sourcePath = tree.getString("frame/fullname");
+            vars.m_line = tree.getInt("frame/line");
+            TreeNode *argsNode = tree.findChild("frame/args");
+            for(int i = 0;argsNode && i < argsNode->getChildCount();i++)
+            {
+                TreeNode *child = argsNode->getChild(i);
+                vars.m_args.append(qMakePair(child->getChildDataString("name"), child->getChildDataString("value")));
+            }
+            vars.m_localVars = m_localVars;
+            m_frameVarsCache[qMakePair(m_selectedThreadId, m_currentFrameIdx)] = vars;
+        }
     }
     else if(ac == GdbComListener::AC_RUNNING)
     {
         m_targetState = ICore::TARGET_RUNNING;
+        m_threadFrameCache.clear();
+        m_frameVarsCache.clear();
+
+        // (The watches can not be deleted while the program is running)
+        QHash<QPair<int,int>, QStringList>::const_iterator iter;
+        for(iter = m_frameWatchCache.constBegin();iter != m_frameWatchCache.constEnd();++iter)
+            m_staleFrameWatches += iter.value();
+        m_frameWatchCache.clear();
 
         debugMsg("is running");
     }
 
     // Get the current thread
     QString threadIdStr = tree.getString("thread-id");
-    if(threadIdStr.isEmpty() == false)
+    if(threadIdStr.isEmpty() == false && m_batchMode == BATCH_NONE)
     {
         int threadId = threadIdStr.toInt(0,0);
         if(m_inf)
@@ -1487,14 +1765,10 @@ void Core::gdbRemoveAllBreakpoints()
     ensureStopped();
     
     // Get id for all breakpoints
-    QList <int> idList;
-    for(int i = 0;i < m_breakpoints.size();i++)
-    {
-        BreakPoint* bkpt = m_breakpoints[i];
-        idList.append(bkpt->m_number);
-        delete bkpt;
-    }
+    QList <int> idList = m_breakpoints.keys();
+    qDeleteAll(m_breakpoints);
     m_breakpoints.clear();
+    m_breakpointsByFile.clear();
 
     // Remove all
     GdbCom& com = GdbCom::getInstance();
@@ -1503,11 +1777,11 @@ void Core::gdbRemoveAllBreakpoints()
     {
         int id = idList[u];
         com.commandF(&resultData, "-break-delete %d", id);
+
+        if(m_inf)
+            m_inf->ICore_onBreakpointDeleted(id);
     }
     
-    if(m_inf)
-        m_inf->ICore_onBreakpointsChanged();
-    
 
 }
 
@@ -1526,10 +1800,11 @@ void Core::gdbRemoveBreakpoint(BreakPoint* bkpt)
         
     com.commandF(&resultData, "-break-delete %d", bkpt->m_number);    
 
-    m_breakpoints.removeOne(bkpt);
+    m_breakpoints.remove(bkpt->m_number);
+    removeBreakpointLocation(bkpt);
 
     if(m_inf)
-        m_inf->ICore_onBreakpointsChanged();
+        m_inf->ICore_onBreakpointDeleted(bkpt->m_number);
     delete bkpt;
     
 }
@@ -1558,18 +1833,10 @@ void Core::gdbGetThreadList()
  */
 BreakPoint* Core::findBreakPoint(QString fullPath, int lineNo)
 {
-    for(int i = 0;i < m_breakpoints.size();i++)
-    {
-        BreakPoint *bkpt = m_breakpoints[i];
-
-    
-        if(bkpt->m_lineNo == lineNo && fullPath == bkpt->m_fullname)
-        {
-            return bkpt;
-        }
-    }
-
-    return NULL;
+    QHash<QString, QMultiMap<int, BreakPoint*> >::const_iterator iter = m_breakpointsByFile.constFind(fullPath);
+    if(iter == m_breakpointsByFile.constEnd())
+        return NULL;
+    return iter.value().value(lineNo, NULL);
 }
 
 
@@ -1578,32 +1845,81 @@ BreakPoint* Core::findBreakPoint(QString fullPath, int lineNo)
  */
 BreakPoint* Core::findBreakPointByNumber(int number)
 {
-    for(int i = 0;i < m_breakpoints.size();i++)
-    {
-        BreakPoint *bkpt = m_breakpoints[i];
+    return m_breakpoints.value(number, NULL);
+}
 
-    
-        if(bkpt->m_number == number)
+
+bool Core::breakpointLessThan(const BreakPoint *a, const BreakPoint *b)
+{
+    return a->m_number < b->m_number;
+}
+
+
+/**
+ * @brief Returns all breakpoints (sorted by number).
+ */
+QList<BreakPoint*> Core::getBreakPoints()
+{
+    QList<BreakPoint*> list = m_breakpoints.values();
+    std::sort(list.begin(), list.end(), breakpointLessThan);
+    return list;
+}
+
+
+/**
+ * @brief Returns the (sorted) line numbers that has a breakpoint in a file.
+ */
+QVector<int> Core::getBreakpointLines(QString fullPath)
+{
+    QVector<int> lineList;
+    QHash<QString, QMultiMap<int, BreakPoint*> >::const_iterator iter = m_breakpointsByFile.constFind(fullPath);
+    if(iter != m_breakpointsByFile.constEnd())
+    {
+        const QMultiMap<int, BreakPoint*> &lineMap = iter.value();
+        QMultiMap<int, BreakPoint*>::const_iterator lineIter;
+        for(lineIter = lineMap.constBegin();lineIter != lineMap.constEnd();++lineIter)
         {
-            return bkpt;
+            if(lineList.isEmpty() || lineList.last() != lineIter.key())
+                lineList.append(lineIter.key());
         }
     }
-    return NULL;
+    return lineList;
+}
+
+
+void Core::addBreakpointLocation(BreakPoint *bkpt)
+{
+    if(bkpt->isWatchPoint())
+        return;
+    m_breakpointsByFile[bkpt->m_fullname].insert(bkpt->m_lineNo, bkpt);
+}
+
+
+void Core::removeBreakpointLocation(BreakPoint *bkpt)
+{
+    QHash<QString, QMultiMap<int, BreakPoint*> >::iterator iter = m_breakpointsByFile.find(bkpt->m_fullname);
+    if(iter == m_breakpointsByFile.end())
+        return;
+    iter.value().remove(bkpt->m_lineNo, bkpt);
+    if(iter.value().isEmpty())
+        m_breakpointsByFile.erase(iter);
 }
 
+
 void Core::dispatchBreakpointDeleted(int id)
 {
 
-    BreakPoint *bkpt = findBreakPointByNumber(id);
+    BreakPoint *bkpt = m_breakpoints.take(id);
     if(bkpt == NULL)
     {
         warnMsg("Unknown breakpoint %d deleted", id);
+        return;
     }
-    else
-        m_breakpoints.removeOne(bkpt);
+    removeBreakpointLocation(bkpt);
+    delete bkpt;
 
     if(m_inf)
-        m_inf->ICore_onBreakpointsChanged();
+        m_inf->ICore_onBreakpointDeleted(id);
 
 }
 
@@ -1612,16 +1928,60 @@ void Core::dispatchBreakpointTree(Tree &tree)
     TreeNode *rootNode = tree.findChild("bkpt");
     if(!rootNode)
         return;
+
+    bool isNew = false;
+    BreakPoint *bkpt = updateBreakpoint(rootNode, &isNew);
+
+    if(m_inf)
+    {
+        if(isNew)
+            m_inf->ICore_onBreakpointAdded(bkpt);
+        else
+            m_inf->ICore_onBreakpointModified(bkpt);
+    }
+}
+
+
+/**
+ * @brief Adds or updates a breakpoint from a 'bkpt' node.
+ * @param isNew    Set to true if the breakpoint was not known before.
+ */
+BreakPoint* Core::updateBreakpoint(TreeNode *rootNode, bool *isNew)
+{
     int lineNo = rootNode->getChildDataInt("line");
     int number = rootNode->getChildDataInt("number");
+    QString type = rootNode->getChildDataString("type");
                 
 
     BreakPoint *bkpt = findBreakPointByNumber(number);
+    *isNew = false;
     if(bkpt == NULL)
     {
         bkpt = new BreakPoint(number);
-        m_breakpoints.push_back(bkpt);
+        m_breakpoints[number] = bkpt;
+        *isNew = true;
+    }
+    else
+        removeBreakpointLocation(bkpt);
+
+    bkpt->m_hitCount = rootNode->getChildDataInt("times");
+    bkpt->m_ignoreCount = rootNode->getChildDataInt("ignore");
+    bkpt->m_condition = rootNode->getChildDataString("cond");
+    bkpt->m_enabled = (rootNode->getChildDataString("enabled") != "n");
+
+    // A watchpoint has no location
+    if(type.endsWith("watchpoint"))
+    {
+        if(type == "read watchpoint")
+            bkpt->m_watchType = BreakPoint::WATCH_READ;
+        else if(type == "acc watchpoint")
+            bkpt->m_watchType = BreakPoint::WATCH_ACCESS;
+        else
+            bkpt->m_watchType = BreakPoint::WATCH_WRITE;
+        bkpt->m_watchExpression = rootNode->getChildDataString("what");
+        return bkpt;
     }
+
     bkpt->m_lineNo = lineNo;
     bkpt->m_fullname = rootNode->getChildDataString("fullname");
 
@@ -1641,10 +2001,11 @@ void Core::dispatchBreakpointTree(Tree &tree)
     
     bkpt->m_funcName = rootNode->getChildDataString("func");
     bkpt->m_addr = rootNode->getChildDataLongLong("addr");
+    bkpt->m_isLogPoint = (type == "dprintf");
 
-    if(m_inf)
-        m_inf->ICore_onBreakpointsChanged();
+    addBreakpointLocation(bkpt);
 
+    return bkpt;
 
     
 }
@@ -1748,6 +2109,7 @@ void Core::onResult(Tree &tree)
         }
         else if(rootName == "threads")
         {
+            QMap<int, ThreadInfo> oldList = m_threadList;
             m_threadList.clear();
             
             // Parse the result
@@ -1776,10 +2138,31 @@ void Core::onResult(Tree &tree)
                 tinfo.m_details = details;
                 tinfo.m_func = funcName;
                 m_threadList[tinfo.m_id] = tinfo;
+
+                // Only report the threads that are new or has changed
+                if(m_inf)
+                {
+                    QMap<int, ThreadInfo>::iterator oldIter = oldList.find(tinfo.m_id);
+                    if(oldIter == oldList.end())
+                        m_inf->ICore_onThreadAdded(tinfo);
+                    else
+                    {
+                        const ThreadInfo &oldInfo = oldIter.value();
+                        if(oldInfo.m_name != tinfo.m_name || oldInfo.m_details != tinfo.m_details ||
+                            oldInfo.m_func != tinfo.m_func)
+                            m_inf->ICore_onThreadChanged(tinfo);
+                        oldList.erase(oldIter);
+                    }
+                }
             }
 
+            // Report the threads that no longer exist
             if(m_inf)
-                m_inf->ICore_onThreadListChanged();
+            {
+                QMap<int, ThreadInfo>::const_iterator iter;
+                for(iter = oldList.constBegin();iter != oldList.constEnd();++iter)
+                    m_inf->ICore_onThreadRemoved(iter.key());
+            }
             
         }
         else if(rootName == "current-thread-id")
@@ -1820,23 +2203,12 @@ void Core::onResult(Tree &tree)
                 }
             }
         }
-        // A stack frame dump?
-        else if(rootName == "stack")
+        // The number of stack frames? (The frames are fetched with getStackFrames() when shown)
+        else if(rootName == "depth")
         {
-            QList<StackFrameEntry> stackFrameList;
-            for(int j = 0;j < rootNode->getChildCount();j++)
-            {
-                const TreeNode *child = rootNode->getChild(j);
-                
-                StackFrameEntry entry;
-                entry.m_functionName = child->getChildDataString("func");
-                entry.m_line = child->getChildDataInt("line");
-                entry.m_sourcePath = child->getChildDataString("fullname");
-                stackFrameList.push_front(entry);
-            }
             if(m_inf)
             {
-                m_inf->ICore_onStackFrameChange(stackFrameList);
+                m_inf->ICore_onStackDepthChanged(rootNode->getDataInt(0));
                 m_inf->ICore_onCurrentFrameChanged(m_currentFrameIdx);
             }
         }
@@ -1952,22 +2324,426 @@ int Core::gdbSetBreakpoint(QString filename, int lineNo)
 
 
 /**
- * @brief Returns a list of threads.
- */
-QList<ThreadInfo> Core::getThreadList()
-{
-    return m_threadList.values();
-}
-
-
-/**
- * @brief Changes context to a specified thread.
+ * @brief Sets the condition of a breakpoint.
+ * @param condition    The expression to evaluate on each hit (empty to make it unconditional).
  */
-void Core::selectThread(int threadId)
+int Core::gdbSetBreakpointCondition(BreakPoint* bkpt, QString condition)
 {
-    if(m_selectedThreadId == threadId)
-        return;
-
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    assert(bkpt != NULL);
+
+    ensureStopped();
+
+    condition = condition.trimmed();
+    QString cmd = QString("-break-condition %1").arg(bkpt->m_number);
+    if(!condition.isEmpty())
+        cmd += " " + condition;
+    if(com.command(&resultData, cmd) == GDB_ERROR)
+    {
+        warnMsg("Failed to set condition of breakpoint %d", bkpt->m_number);
+        return -1;
+    }
+
+    // gdb does not notify changes that are made with MI commands
+    bkpt->m_condition = condition;
+    if(m_inf)
+        m_inf->ICore_onBreakpointModified(bkpt);
+    return 0;
+}
+
+
+/**
+ * @brief Sets the number of times a breakpoint should be passed before it stops the program.
+ */
+int Core::gdbSetBreakpointIgnoreCount(BreakPoint* bkpt, int count)
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    assert(bkpt != NULL);
+
+    ensureStopped();
+
+    if(com.commandF(&resultData, "-break-after %d %d", bkpt->m_number, count) == GDB_ERROR)
+    {
+        warnMsg("Failed to set ignore count of breakpoint %d", bkpt->m_number);
+        return -1;
+    }
+
+    bkpt->m_ignoreCount = count;
+    if(m_inf)
+        m_inf->ICore_onBreakpointModified(bkpt);
+    return 0;
+}
+
+
+/**
+ * @brief Quotes a string to be passed as a argument to a MI command.
+ *
+ * Backslashes are kept so that escape sequences (Eg: '\n') reaches gdb.
+ */
+static QString quoteMiArgument(QString str)
+{
+    str.replace("\"", "\\\"");
+    return "\"" + str + "\"";
+}
+
+
+/**
+ * @brief Sets a log point (dprintf) that prints a message to the gdb output without stopping the program.
+ * @param format    The printf format of the message (Eg: "x=%d").
+ * @param argList   The expressions to print (Eg: ["x"]).
+ */
+int Core::gdbSetLogPoint(QString filename, int lineNo, QString format, QStringList argList)
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    if(filename.isEmpty())
+        return -1;
+
+    ensureStopped();
+
+    // Each message on its own line
+    if(!format.endsWith("\\n"))
+        format += "\\n";
+
+    QString cmd = QString("-dprintf-insert %1:%2 %3").arg(filename).arg(lineNo).arg(quoteMiArgument(format));
+    for(int i = 0;i < argList.size();i++)
+    {
+        QString arg = argList[i].trimmed();
+        if(!arg.isEmpty())
+            cmd += " " + quoteMiArgument(arg);
+    }
+    if(com.command(&resultData, cmd) == GDB_ERROR)
+    {
+        warnMsg("Failed to set log point at %s:%d", stringToCStr(filename), lineNo);
+        return -1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Sets a watchpoint that stops the program when a expression is accessed.
+ * @param autoContinue   True if the program should continue once the trigger has been reported.
+ */
+int Core::gdbSetWatchPoint(QString expression, BreakPoint::WatchType type, bool autoContinue)
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    expression = expression.trimmed();
+    if(expression.isEmpty())
+        return -1;
+
+    ensureStopped();
+
+    QString cmd = "-break-watch ";
+    if(type == BreakPoint::WATCH_READ)
+        cmd += "-r ";
+    else if(type == BreakPoint::WATCH_ACCESS)
+        cmd += "-a ";
+    cmd += quoteMiArgument(expression);
+    if(com.command(&resultData, cmd) == GDB_ERROR)
+    {
+        warnMsg("Failed to set watchpoint on '%s'", stringToCStr(expression));
+        return -1;
+    }
+
+    // The result is 'wpt', 'hw-rwpt' or 'hw-awpt' depending on the type
+    TreeNode *node = resultData.findChild("wpt");
+    if(!node)
+        node = resultData.findChild("hw-rwpt");
+    if(!node)
+        node = resultData.findChild("hw-awpt");
+    if(!node)
+        return -1;
+
+    int number = node->getChildDataInt("number");
+    BreakPoint *bkpt = findBreakPointByNumber(number);
+    if(bkpt == NULL)
+    {
+        bkpt = new BreakPoint(number);
+        m_breakpoints[number] = bkpt;
+    }
+    bkpt->m_watchType = type;
+    bkpt->m_watchExpression = node->getChildDataString("exp");
+    bkpt->m_autoContinue = autoContinue;
+
+    if(m_inf)
+        m_inf->ICore_onBreakpointAdded(bkpt);
+    return 0;
+}
+
+
+/**
+ * @brief Sets a watchpoint on a variable in the watch list.
+ */
+int Core::gdbSetVarWatchPoint(QString watchId, BreakPoint::WatchType type, bool autoContinue)
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    // Get the expression of the (child) variable
+    if(com.commandF(&resultData, "-var-info-path-expression %s", stringToCStr(watchId)) == GDB_ERROR)
+        return -1;
+    QString expression = resultData.getString("path_expr");
+
+    return gdbSetWatchPoint(expression, type, autoContinue);
+}
+
+
+/**
+ * @brief Sets a watchpoint on a block of memory.
+ */
+int Core::gdbSetMemoryWatchPoint(quint64 address, int size, BreakPoint::WatchType type, bool autoContinue)
+{
+    QString addrStr = QString("0x%1").arg(address, 0, 16);
+    QString expression;
+    if(size == 1)
+        expression = "*(unsigned char*)" + addrStr;
+    else if(size == 2)
+        expression = "*(unsigned short*)" + addrStr;
+    else if(size == 4)
+        expression = "*(unsigned int*)" + addrStr;
+    else if(size == 8)
+        expression = "*(unsigned long long*)" + addrStr;
+    else
+        expression = QString("*(unsigned char(*)[%1])").arg(size) + addrStr;
+
+    return gdbSetWatchPoint(expression, type, autoContinue);
+}
+
+
+/**
+ * @brief Reports a watchpoint trigger or a watchpoint that has gone out of scope.
+ * @return true if the program should be continued without reporting the stop.
+ */
+bool Core::dispatchWatchPointTrigger(Tree &tree, ICore::StopReason reason)
+{
+    // gdb deletes a watchpoint when the frame of the expression is left
+    if(reason == ICore::WATCHPOINT_SCOPE)
+    {
+        int number = tree.getInt("wpnum");
+        if(findBreakPointByNumber(number))
+            dispatchBreakpointDeleted(number);
+        return false;
+    }
+
+    WatchPointHit hit;
+    const char *nodeNames[] = { "wpt", "hw-rwpt", "hw-awpt" };
+    for(int i = 0;i < (int)(sizeof(nodeNames)/sizeof(nodeNames[0]));i++)
+    {
+        TreeNode *node = tree.findChild(nodeNames[i]);
+        if(node)
+        {
+            hit.m_number = node->getChildDataInt("number");
+            hit.m_expression = node->getChildDataString("exp");
+            break;
+        }
+    }
+    hit.m_oldValue = tree.getString("value/old");
+    hit.m_newValue = tree.getString("value/new");
+    if(hit.m_newValue.isEmpty())
+        hit.m_newValue = tree.getString("value/value");
+    hit.m_pc = tree.getString("frame/addr").toULongLong(0, 0);
+    hit.m_threadId = tree.getInt("thread-id");
+    hit.m_fullname = tree.getString("frame/fullname");
+    hit.m_lineNo = tree.getInt("frame/line");
+    hit.m_funcName = tree.getString("frame/func");
+
+    if(m_inf)
+        m_inf->ICore_onWatchPointTriggered(hit);
+
+    BreakPoint *bkpt = findBreakPointByNumber(hit.m_number);
+    return (bkpt && bkpt->m_autoContinue) ? true : false;
+}
+
+
+/**
+ * @brief Sets a list of breakpoints.
+ *
+ * All the -break-insert commands are sent to gdb at once and the user
+ * interface is not updated until all of them are done. Breakpoints that
+ * already exist are skipped.
+ * @return The number of breakpoints that failed to be set.
+ */
+int Core::gdbSetBreakpoints(QList<SettingsBreakpoint> list)
+{
+    GdbCom& com = GdbCom::getInstance();
+    QStringList cmdList;
+    QList<Tree*> resultDataList;
+    QList<SettingsBreakpoint> sentList;
+
+    for(int i = 0;i < list.size();i++)
+    {
+        SettingsBreakpoint bkptCfg = list[i];
+        if(bkptCfg.m_filename.isEmpty())
+            continue;
+        if(findBreakPoint(bkptCfg.m_filename, bkptCfg.m_lineNo) != NULL)
+            continue;
+
+        cmdList.append(QString("-break-insert %1:%2").arg(bkptCfg.m_filename).arg(bkptCfg.m_lineNo));
+        resultDataList.append(new Tree);
+        sentList.append(bkptCfg);
+    }
+    if(cmdList.isEmpty())
+        return 0;
+
+    ensureStopped();
+
+    QVector<GdbResult> resultList = com.commandBatch(cmdList, resultDataList, false);
+
+    QList<BreakPoint*> addedList;
+    QStringList failedList;
+    for(int i = 0;i < resultList.size();i++)
+    {
+        TreeNode *rootNode = resultDataList[i]->findChild("bkpt");
+        if(resultList[i] == GDB_ERROR || rootNode == NULL)
+        {
+            failedList.append(QString("%1:%2").arg(sentList[i].m_filename).arg(sentList[i].m_lineNo));
+            continue;
+        }
+
+        bool isNew = false;
+        BreakPoint *bkpt = updateBreakpoint(rootNode, &isNew);
+        if(isNew)
+            addedList.append(bkpt);
+    }
+    qDeleteAll(resultDataList);
+
+    // Update the user interface once all breakpoints are set
+    if(m_inf)
+    {
+        for(int i = 0;i < addedList.size();i++)
+            m_inf->ICore_onBreakpointAdded(addedList[i]);
+    }
+
+    if(!failedList.isEmpty())
+    {
+        warnMsg("Failed to set %d of %d breakpoints: %s", failedList.size(), cmdList.size(),
+                stringToCStr(failedList.join(", ")));
+    }
+    return failedList.size();
+}
+
+
+/**
+ * @brief Returns a list of threads.
+ */
+QList<ThreadInfo> Core::getThreadList()
+{
+    return m_threadList.values();
+}
+
+
+/**
+ * @brief Parses the result of -stack-list-frames (innermost frame first).
+ */
+QList<StackFrameEntry> Core::parseStackFrames(TreeNode *stackNode)
+{
+    QList<StackFrameEntry> frameList;
+    for(int j = 0;j < stackNode->getChildCount();j++)
+    {
+        const TreeNode *child = stackNode->getChild(j);
+
+        StackFrameEntry entry;
+        entry.m_functionName = child->getChildDataString("func");
+        entry.m_line = child->getChildDataInt("line");
+        entry.m_sourcePath = child->getChildDataString("fullname");
+        frameList.push_back(entry);
+    }
+    return frameList;
+}
+
+
+/**
+ * @brief Returns a range of the stack frames of the current thread (innermost frame first).
+ * @param lowFrame    The first frame (0 being the innermost frame).
+ * @param highFrame   The last frame.
+ */
+QList<StackFrameEntry> Core::getStackFrames(int lowFrame, int highFrame)
+{
+    GdbCom& com = GdbCom::getInstance();
+    QList<StackFrameEntry> frameList;
+
+    if(isRunning())
+        return frameList;
+
+    Tree resultData;
+    GdbResult res = com.commandF(&resultData, "-stack-list-frames %d %d", lowFrame, highFrame);
+
+    TreeNode *stackNode = resultData.findChild("stack");
+    if(res != GDB_ERROR && stackNode)
+        frameList = parseStackFrames(stackNode);
+    return frameList;
+}
+
+
+/**
+ * @brief Returns the stack frames of a list of threads (innermost frame first).
+ *
+ * At most THREAD_MAX_FRAME_COUNT frames are returned for each thread. The frames of the threads that are not cached are asked for with one
+ * pipelined batch of commands. They are cached until the program resumes.
+ */
+QHash<int, QList<StackFrameEntry> > Core::getThreadFrames(QList<int> threadIdList)
+{
+    GdbCom& com = GdbCom::getInstance();
+    QHash<int, QList<StackFrameEntry> > frameMap;
+    QList<int> fetchList;
+
+    for(int i = 0;i < threadIdList.size();i++)
+    {
+        int threadId = threadIdList[i];
+        if(m_threadFrameCache.contains(threadId))
+            frameMap[threadId] = m_threadFrameCache[threadId];
+        else if(!fetchList.contains(threadId))
+            fetchList.append(threadId);
+    }
+
+    if(fetchList.isEmpty() || isRunning())
+        return frameMap;
+
+    QStringList cmdList;
+    QList<Tree*> resultDataList;
+    for(int i = 0;i < fetchList.size();i++)
+    {
+        cmdList.append(QString("-stack-list-frames --thread %1 0 %2").arg(fetchList[i]).arg(THREAD_MAX_FRAME_COUNT-1));
+        resultDataList.append(new Tree);
+    }
+
+    // (The results should not update the stack of the current thread)
+    QVector<GdbResult> resultList = com.commandBatch(cmdList, resultDataList, false);
+
+    for(int i = 0;i < fetchList.size();i++)
+    {
+        int threadId = fetchList[i];
+        QList<StackFrameEntry> frameList;
+        TreeNode *stackNode = resultDataList[i]->findChild("stack");
+        if(resultList[i] != GDB_ERROR && stackNode)
+        {
+            frameList = parseStackFrames(stackNode);
+            m_threadFrameCache[threadId] = frameList;
+        }
+        frameMap[threadId] = frameList;
+    }
+    qDeleteAll(resultDataList);
+
+    return frameMap;
+}
+
+
+/**
+ * @brief Changes context to a specified thread.
+ */
+void Core::selectThread(int threadId)
+{
+    if(m_selectedThreadId == threadId)
+        return;
+
     GdbCom& com = GdbCom::getInstance();
     Tree resultData;
     
@@ -1977,6 +2753,14 @@ void Core::selectThread(int threadId)
 
         
         m_selectedThreadId = threadId;
+
+        // The stack shown is the one of the previous thread
+        if(m_inf)
+            m_inf->ICore_onStackDepthChanged(0);
+        if(m_visiblePanels & PANEL_STACK)
+            com.commandBatch(getPanelQueries(PANEL_STACK), QList<Tree*>());
+        else
+            m_stalePanels |= PANEL_STACK;
     }
 }
 
@@ -1995,16 +2779,73 @@ void Core::selectFrame(int selectedFrameIdx)
     {
         return;
     }
-    if(m_currentFrameIdx != selectedFrameIdx)
+    if(m_currentFrameIdx == selectedFrameIdx)
+        return;
+
+    // Already visited since the program stopped?
+    QPair<int,int> key(m_selectedThreadId, selectedFrameIdx);
+    if(m_frameVarsCache.contains(key))
     {
-        com.commandF(NULL, "-stack-select-frame %d", selectedFrameIdx);
+        if(com.commandF(&resultData, "-stack-select-frame %d", selectedFrameIdx) == GDB_ERROR)
+            return;
+        m_currentFrameIdx = selectedFrameIdx;
+        dispatchFrameVars(m_frameVarsCache[key]);
+        return;
+    }
 
+    // Select the frame and get its location and variables in one batch
+    QStringList cmdList;
+    cmdList.append(QString("-stack-select-frame %1").arg(selectedFrameIdx));
+    cmdList.append("-stack-info-frame");
+    cmdList.append("-stack-list-variables --simple-values");
+    QList<Tree*> resultDataList;
+    for(int i = 0;i < cmdList.size();i++)
+        resultDataList.append(new Tree);
+    QVector<GdbResult> resultList = com.commandBatch(cmdList, resultDataList, false);
 
-        com.commandF(&resultData, "-stack-info-frame");
+    if(resultList[0] != GDB_ERROR && resultList[1] != GDB_ERROR && resultList[2] != GDB_ERROR)
+    {
+        FrameVars vars;
+        vars.m_sourcePath = resultDataList[1]->getString("frame/fullname");
+        vars.m_line = resultDataList[1]->getInt("frame/line");
+        TreeNode *varsNode = resultDataList[2]->findChild("variables");
+        for(int j = 0;varsNode && j < varsNode->getChildCount();j++)
+        {
+            TreeNode *child = varsNode->getChild(j);
+            QString varName = child->getChildDataString("name");
+            vars.m_localVars.append(varName);
+            if(child->getChildDataInt("arg", 0))
+                vars.m_args.append(qMakePair(varName, child->getChildDataString("value")));
+        }
 
-        com.commandF(NULL, "-stack-list-variables --no-values");
+        m_currentFrameIdx = selectedFrameIdx;
+        m_frameVarsCache[key] = vars;
+        dispatchFrameVars(vars);
     }
+    qDeleteAll(resultDataList);
+}
 
+
+/**
+ * @brief Reports the location and the variables of the selected frame.
+ */
+void Core::dispatchFrameVars(const FrameVars &vars)
+{
+    m_localVars = vars.m_localVars;
+    if(!m_inf)
+        return;
+
+    m_inf->ICore_onStopped(ICore::UNKNOWN, vars.m_sourcePath, vars.m_line);
+
+    m_inf->ICore_onFrameVarReset();
+    for(int i = 0;i < vars.m_args.size();i++)
+        m_inf->ICore_onFrameVarChanged(vars.m_args[i].first, vars.m_args[i].second);
+
+    // (A hidden auto variables panel is updated when it is shown)
+    if(m_visiblePanels & PANEL_AUTO)
+        m_inf->ICore_onLocalVarChanged(m_localVars);
+    else
+        m_stalePanels |= PANEL_AUTO;
 }
 
 
@@ -2100,6 +2941,119 @@ quint64 Core::getAddress(VarWatch &w)
 
 
 
+/**
+ * @brief Starts a batch step command.
+ *
+ * The program is stepped (or continued) by Core without notifying the gui
+ * until the batch is done. This way the gui is only updated once.
+ * @return 0 on success.
+ */
+int Core::startBatch(int mode, int count, QString expression)
+{
+    GdbCom& com = GdbCom::getInstance();
+    Tree resultData;
+
+    if(m_targetState != ICore::TARGET_STOPPED)
+    {
+        if(m_inf)
+            m_inf->ICore_onMessage("Program is not stopped");
+        return -1;
+    }
+    if(count <= 0)
+        return -1;
+
+    m_batchMode = mode;
+    m_batchCount = count;
+    m_batchExpression = expression;
+
+    if(com.commandF(&resultData, mode == BATCH_CONTINUE ? "-exec-continue" : "-exec-next") == GDB_ERROR)
+    {
+        m_batchMode = BATCH_NONE;
+        return -1;
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Executes the next row in the program a number of times.
+ */
+int Core::gdbNextMany(int count)
+{
+    return startBatch(BATCH_NEXT, count, "");
+}
+
+
+/**
+ * @brief Executes the next row in the program until a expression is true.
+ *
+ * The program is stepped at most STEP_UNTIL_MAX_COUNT times.
+ */
+int Core::gdbNextUntil(QString expression)
+{
+    expression = expression.trimmed();
+    if(expression.isEmpty())
+        return -1;
+    return startBatch(BATCH_NEXT_UNTIL, STEP_UNTIL_MAX_COUNT, expression);
+}
+
+
+/**
+ * @brief Resumes the execution until breakpoints has been hit a number of times.
+ */
+int Core::gdbContinueHits(int count)
+{
+    return startBatch(BATCH_CONTINUE, count, "");
+}
+
+
+/**
+ * @brief Resumes the program again if the running batch step command is not done.
+ *
+ * The batch is ended if the program stopped for any other reason than the
+ * one the batch is waiting for (Eg: a signal or a breakpoint hit while stepping).
+ * @return true if the program was resumed.
+ */
+bool Core::continueBatch(ICore::StopReason reason)
+{
+    GdbCom& com = GdbCom::getInstance();
+    bool resume = false;
+
+    if(m_batchMode == BATCH_NEXT)
+        resume = (reason == ICore::END_STEPPING_RANGE && --m_batchCount > 0);
+    else if(m_batchMode == BATCH_CONTINUE)
+        resume = (reason == ICore::BREAKPOINT_HIT && --m_batchCount > 0);
+    else if(m_batchMode == BATCH_NEXT_UNTIL && reason == ICore::END_STEPPING_RANGE)
+    {
+        Tree resultData;
+        if(com.commandF(&resultData, "-data-evaluate-expression %s",
+                    stringToCStr(quoteMiArgument(m_batchExpression))) != GDB_DONE)
+        {
+            warnMsg("Failed to evaluate '%s'", stringToCStr(m_batchExpression));
+        }
+        else
+        {
+            QString value = resultData.getString("value");
+            bool isTrue = !(value == "0" || value == "false" || value == "0x0");
+            if(!isTrue && --m_batchCount > 0)
+                resume = true;
+            else if(!isTrue)
+                warnMsg("Stopped after %d steps without '%s' being true",
+                        STEP_UNTIL_MAX_COUNT, stringToCStr(m_batchExpression));
+        }
+    }
+
+    if(resume)
+    {
+        if(com.command(NULL, m_batchMode == BATCH_CONTINUE ? "-exec-continue" : "-exec-next") != GDB_ERROR)
+            return true;
+    }
+    m_batchMode = BATCH_NONE;
+    return false;
+}
+
+
+
 /**
 * @brief Checks if the target is running (or if it is stopped or finnished).
 * @return true if the target is running.
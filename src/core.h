@@ -12,6 +12,7 @@
 #include <QList>
 #include <QMap>
 #include <QHash>
+#include <QPair>
 #include <QSocketNotifier>
 #include <QObject>
 #include <QVector>
@@ -42,6 +43,19 @@ struct StackFrameEntry
 };
 
 
+/**
+ * @brief The location and the variables of a selected stack frame.
+ */
+struct FrameVars
+{
+    public:
+        QString m_sourcePath; //!< The full path of the source file. Eg: "/test/file.c".
+        int m_line;
+        QList<QPair<QString, QString> > m_args; //!< The name and value of the arguments.
+        QStringList m_localVars; //!< The names of the arguments and local variables.
+};
+
+
 class SourceFile
 {
 public:
@@ -56,7 +70,13 @@ public:
 class BreakPoint
 {
 public:
-    BreakPoint(int number) : m_number(number) { };
+    typedef enum { NOT_WATCH = 0, WATCH_WRITE, WATCH_READ, WATCH_ACCESS } WatchType;
+
+    BreakPoint(int number) : m_number(number), m_lineNo(0), m_addr(0), m_hitCount(0),
+                m_ignoreCount(0), m_enabled(true), m_isLogPoint(false),
+                m_watchType(NOT_WATCH), m_autoContinue(false) { };
+
+    bool isWatchPoint() const { return m_watchType != NOT_WATCH; };
 
 public:
     int m_number;
@@ -64,12 +84,40 @@ public:
     int m_lineNo;
     QString m_funcName;
     unsigned long long m_addr;
+    int m_hitCount; //!< Number of times the breakpoint has been hit.
+    int m_ignoreCount; //!< Number of hits to ignore before stopping.
+    QString m_condition; //!< Condition expression (empty if unconditional).
+    bool m_enabled;
+    bool m_isLogPoint; //!< True for a dprintf breakpoint that prints without stopping.
+    WatchType m_watchType; //!< The kind of watchpoint (NOT_WATCH for a ordinary breakpoint).
+    QString m_watchExpression; //!< The expression that is watched.
+    bool m_autoContinue; //!< Continue the program when a trigger of the watchpoint has been reported.
     
 private:
     BreakPoint(){};
 };
 
 
+/**
+ * @brief A trigger of a watchpoint.
+ */
+class WatchPointHit
+{
+public:
+    WatchPointHit() : m_number(0), m_pc(0), m_threadId(0), m_lineNo(0) {};
+
+    int m_number; //!< The watchpoint number.
+    QString m_expression;
+    QString m_oldValue; //!< The value before a write (empty for a read).
+    QString m_newValue; //!< The value after a write or the value read.
+    unsigned long long m_pc;
+    int m_threadId;
+    QString m_fullname;
+    int m_lineNo;
+    QString m_funcName;
+};
+
+
 /**
  * @brief The value of a variable.
  */
@@ -168,7 +216,9 @@ class ICore
         SIGNAL_RECEIVED,
         EXITED_NORMALLY,
         FUNCTION_FINISHED,
-        EXITED
+        EXITED,
+        WATCHPOINT_TRIGGER,
+        WATCHPOINT_SCOPE
     };
     
     virtual void ICore_onStopped(StopReason reason, QString path, int lineNo) = 0;
@@ -180,14 +230,20 @@ class ICore
     virtual void ICore_onWatchVarChanged(VarWatch &watch) = 0;
     virtual void ICore_onWatchVarDeleted(VarWatch &watch) = 0;
     virtual void ICore_onConsoleStream(QString text) = 0;
-    virtual void ICore_onBreakpointsChanged() = 0;
-    virtual void ICore_onThreadListChanged() = 0;
+    virtual void ICore_onBreakpointAdded(BreakPoint *bkpt) = 0;
+    virtual void ICore_onBreakpointModified(BreakPoint *bkpt) = 0;
+    virtual void ICore_onBreakpointDeleted(int number) = 0;
+    virtual void ICore_onWatchPointTriggered(WatchPointHit hit) = 0;
+    virtual void ICore_onThreadAdded(ThreadInfo info) = 0;
+    virtual void ICore_onThreadChanged(ThreadInfo info) = 0;
+    virtual void ICore_onThreadRemoved(int threadId) = 0;
     virtual void ICore_onCurrentThreadChanged(int threadId) = 0;
-    virtual void ICore_onStackFrameChange(QList<StackFrameEntry> stackFrameList) = 0;
+    virtual void ICore_onStackDepthChanged(int depth) = 0;
     virtual void ICore_onMessage(QString message) = 0;
     virtual void ICore_onTargetOutput(QString message) = 0;
     virtual void ICore_onCurrentFrameChanged(int frameIdx) = 0;
     virtual void ICore_onSourceFileListChanged() = 0;
+    virtual void ICore_onSourceFilesUpdated(QStringList addedList, QStringList removedList) = 0;
     virtual void ICore_onSourceFileChanged(QString filename) = 0;
 
     /**
@@ -215,7 +271,17 @@ private:
     ~Core();
 
 public:
-    
+    /**
+     * @brief Panels that are updated when the program stops.
+     */
+    enum Panel
+    {
+        PANEL_THREADS = 0x1,
+        PANEL_STACK = 0x2,
+        PANEL_WATCH = 0x4,
+        PANEL_AUTO = 0x8,
+        PANEL_ALL = 0xf
+    };
 
     static Core& getInstance();
     int initPid(Settings *cfg, QString gdbPath, QString programPath, int pid);
@@ -224,8 +290,11 @@ public:
     int initCoreDump(Settings *cfg, QString gdbPath, QString programPath, QString coreDumpFile);
     int initRemote(Settings *cfg, QString gdbPath, QString programPath, QString tcpHost, int tcpPort);
     int evaluateExpression(QString expr, QString *data);
+
+    static QStringList getEarlyInitCommands(Settings *cfg);
     
     void setListener(ICore *inf) { m_inf = inf; };
+    void setPanelVisible(Panel panel, bool visible);
 
     
 private:
@@ -240,12 +309,24 @@ private:
 
     void dispatchBreakpointDeleted(int id);
     void dispatchBreakpointTree(Tree &tree);
+    BreakPoint* updateBreakpoint(TreeNode *rootNode, bool *isNew);
+    bool dispatchWatchPointTrigger(Tree &tree, ICore::StopReason reason);
+    void addBreakpointLocation(BreakPoint *bkpt);
+    void removeBreakpointLocation(BreakPoint *bkpt);
+    static bool breakpointLessThan(const BreakPoint *a, const BreakPoint *b);
     static ICore::StopReason parseReasonString(QString string);
     void detectMemoryDepth();
+    GdbResult loadSymbols(Settings *cfg, QString cmd);
     static int openPseudoTerminal();
     void ensureStopped();
+    static QStringList getPanelQueries(int panels);
+    static QList<StackFrameEntry> parseStackFrames(TreeNode *stackNode);
+    int startBatch(int mode, int count, QString expression);
+    bool continueBatch(ICore::StopReason reason);
     int runInitCommands(Settings *cfg);
     int priv_gdbVarWatchCreate(QString varName, QString watchId, VarWatch* watch);
+    static void parseVarCreateResult(VarWatch *watch, Tree &resultData);
+    void dispatchFrameVars(const FrameVars &vars);
 
 public:
     int gdbSetBreakpointAtFunc(QString func);
@@ -253,8 +334,11 @@ public:
     void gdbStepIn();
     void gdbStepOut();
     void gdbContinue();
+    int gdbNextMany(int count);
+    int gdbNextUntil(QString expression);
+    int gdbContinueHits(int count);
     void gdbRun();
-    bool gdbGetFiles();
+    bool gdbGetFiles(QStringList *addedList = NULL, QStringList *removedList = NULL, bool inBackground = false);
 
     void gdbManualCommand(QString cmd);
 
@@ -270,8 +354,14 @@ public:
     int jump(QString filename, int lineNo);
 
     int gdbSetBreakpoint(QString filename, int lineNo);
+    int gdbSetBreakpoints(QList<SettingsBreakpoint> list);
+    int gdbSetBreakpointCondition(BreakPoint* bkpt, QString condition);
+    int gdbSetBreakpointIgnoreCount(BreakPoint* bkpt, int count);
+    int gdbSetLogPoint(QString filename, int lineNo, QString format, QStringList argList);
+    int gdbSetWatchPoint(QString expression, BreakPoint::WatchType type, bool autoContinue);
+    int gdbSetVarWatchPoint(QString watchId, BreakPoint::WatchType type, bool autoContinue);
+    int gdbSetMemoryWatchPoint(quint64 address, int size, BreakPoint::WatchType type, bool autoContinue);
     void gdbGetThreadList();
-    void getStackFrames();
     void stop();
     int gdbExpandVarWatchChildren(QString watchId);
     int gdbGetMemory(quint64 addr, size_t count, QByteArray *data);
@@ -280,23 +370,29 @@ public:
     void selectFrame(int selectedFrameIdx);
 
     // Breakpoints
-    QList<BreakPoint*> getBreakPoints() { return m_breakpoints; };
+    QList<BreakPoint*> getBreakPoints();
     BreakPoint* findBreakPoint(QString fullPath, int lineNo);
     BreakPoint* findBreakPointByNumber(int number);
+    QVector<int> getBreakpointLines(QString fullPath);
     void gdbRemoveBreakpoint(BreakPoint* bkpt);
     void gdbRemoveAllBreakpoints();
 
     QList<ThreadInfo> getThreadList();
+    QList<StackFrameEntry> getStackFrames(int lowFrame, int highFrame);
+    QHash<int, QList<StackFrameEntry> > getThreadFrames(QList<int> threadIdList);
 
     // Watch
     VarWatch *getVarWatchInfo(QString watchId);
     QList <VarWatch*> getWatchChildren(VarWatch &watch);
     int gdbAddVarWatch(QString varName, VarWatch **watchPtr);
+    QList<VarWatch*> gdbAddVarWatches(QStringList varNames);
+    QList<VarWatch*> gdbGetFrameVarWatches(QStringList varNames);
     void gdbRemoveVarWatch(QString watchId);
     QString gdbGetVarWatchName(QString watchId);
 
     
     QVector <SourceFile*> getSourceFiles() { return m_sourceFiles; };
+    SourceFile *findSourceFile(QString fullName) { return m_sourceFileLookup.value(fullName, NULL); };
 
     void writeTargetStdin(QString text);
 
@@ -307,9 +403,15 @@ private slots:
 
 private:
     ICore *m_inf;
-    QList<BreakPoint*> m_breakpoints;
+    QHash<int, BreakPoint*> m_breakpoints; //!< Number => breakpoint
+    QHash<QString, QMultiMap<int, BreakPoint*> > m_breakpointsByFile; //!< Fullname => line => breakpoints
     QVector <SourceFile*> m_sourceFiles;
+    QHash <QString, SourceFile*> m_sourceFileLookup; //!< Fullname => SourceFile
     QMap <int, ThreadInfo> m_threadList;
+    QHash <int, QList<StackFrameEntry> > m_threadFrameCache; //!< Thread id => frames (until the program resumes)
+    QHash <QPair<int,int>, FrameVars> m_frameVarsCache; //!< (Thread id, frame) => variables (until the program resumes)
+    QHash <QPair<int,int>, QStringList> m_frameWatchCache; //!< (Thread id, frame) => watch ids of the auto variables (until the program resumes)
+    QStringList m_staleFrameWatches; //!< Watches of the auto variables to delete once the program has stopped.
     int m_selectedThreadId;
     ICore::TargetState m_targetState;
     ICore::TargetState m_lastTargetState;
@@ -320,6 +422,12 @@ private:
     bool m_isRemote; //!< True if "remote target" or false if it is a "local target".
     int m_ptsFd;
     bool m_scanSources; //!< True if the source filelist may have changed
+    int m_visiblePanels; //!< The panels (PANEL_*) that are shown
+    int m_stalePanels; //!< The panels (PANEL_*) that has not been updated since the program stopped
+    enum { BATCH_NONE, BATCH_NEXT, BATCH_NEXT_UNTIL, BATCH_CONTINUE };
+    int m_batchMode; //!< The batch step command (BATCH_*) that is running
+    int m_batchCount; //!< Number of steps or breakpoint hits left of the batch
+    QString m_batchExpression; //!< The expression to stop at when m_batchMode is BATCH_NEXT_UNTIL
     QSocketNotifier  *m_ptsListener;
 
     QStringList m_localVars;
@@ -0,0 +1,767 @@
+/*
+ * Copyright (C) 2014-2020 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+// #define ENABLE_DEBUGMSG
+
+#include "cxxtagscanner.h"
+
+#include <QStringList>
+#include <QFile>
+
+#include "util.h"
+#include "settings.h"
+#include "log.h"
+
+
+/**
+ * @brief Checks if a character can be part of a name.
+ */
+static bool isNameChar(QChar c)
+{
+    return (c.isLetterOrNumber() || c == '_' || c == '$') ? true : false;
+}
+
+
+CxxTagScanner::CxxTagScanner()
+    : m_cfg(NULL)
+    ,m_tokenIdx(0)
+    ,m_skipStmt(false)
+{
+    QStringList reservedList;
+    reservedList << "if" << "else" << "for" << "while" << "do" << "switch" << "case" << "default"
+        << "return" << "break" << "continue" << "goto" << "sizeof" << "typedef" << "typename"
+        << "template" << "namespace" << "using" << "class" << "struct" << "union" << "enum"
+        << "public" << "protected" << "private" << "friend" << "virtual" << "explicit" << "inline"
+        << "static" << "extern" << "register" << "mutable" << "volatile" << "const" << "constexpr"
+        << "override" << "final" << "noexcept" << "throw" << "operator" << "new" << "delete"
+        << "unsigned" << "signed" << "void" << "bool" << "char" << "short" << "int" << "long"
+        << "float" << "double" << "auto" << "true" << "false" << "nullptr" << "this";
+    for(int u = 0;u < reservedList.size();u++)
+    {
+        m_reserved[reservedList[u]] = true;
+    }
+}
+
+CxxTagScanner::~CxxTagScanner()
+{
+}
+
+
+void CxxTagScanner::setConfig(Settings *cfg)
+{
+    m_cfg = cfg;
+    m_highlighter.setConfig(cfg);
+}
+
+
+/**
+ * @brief Checks if a file is a C/C++ source or header file.
+ */
+bool CxxTagScanner::isCxxFile(QString filepath)
+{
+    QString extension = getExtensionPart(filepath).toLower();
+    if(extension == ".c" || extension == ".h" ||
+        extension == ".cpp" || extension == ".hpp" ||
+        extension == ".cc" || extension == ".hh" ||
+        extension == ".cxx" || extension == ".hxx" ||
+        extension == ".c++" || extension == ".h++" ||
+        extension == ".inl" || extension == ".tcc" ||
+        extension == ".ino")
+        return true;
+    return false;
+}
+
+
+/**
+ * @brief Scans a C/C++ file for tags.
+ */
+int CxxTagScanner::scan(QString filepath, QList<Tag> *taglist)
+{
+    m_filepath = filepath;
+
+    QFile file(filepath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        errorMsg("Failed to open '%s'", stringToCStr(filepath));
+        return -1;
+    }
+    QString text = QString::fromUtf8(file.readAll());
+
+    tokenize(text);
+
+    parse(taglist);
+
+    m_tokens.clear();
+    m_stmt.clear();
+    m_scopes.clear();
+
+    return 0;
+}
+
+
+/**
+ * @brief Splits the text into tokens using the syntax highlighter.
+ *
+ * Comments, whitespaces and preprocessor rows are removed.
+ */
+void CxxTagScanner::tokenize(QString text)
+{
+    m_tokens.clear();
+
+    m_highlighter.colorize(text);
+
+    int lineNr = 1;
+    bool isContinued = false;
+    for(unsigned int rowIdx = 0;rowIdx < m_highlighter.getRowCount();rowIdx++)
+    {
+        QVector<TextField*> fields = m_highlighter.getRow(rowIdx);
+
+        // A preprocessor row (or the continuation of one)?
+        bool isCppRow = isContinued;
+        TextField *lastField = NULL;
+        for(int j = 0;j < fields.size();j++)
+        {
+            TextField *field = fields[j];
+            if(field->m_type == TextField::SPACES || field->m_type == TextField::COMMENT)
+                continue;
+            if(lastField == NULL && field->isHash())
+                isCppRow = true;
+            lastField = field;
+        }
+        isContinued = (isCppRow && lastField != NULL && lastField->m_text.endsWith('\\')) ? true : false;
+
+        bool isGlued = false;
+        for(int j = 0;j < fields.size();j++)
+        {
+            TextField *field = fields[j];
+            bool isSpace = (field->m_type == TextField::SPACES || field->m_type == TextField::COMMENT) ? true : false;
+            if(!isCppRow && !isSpace)
+            {
+                if(field->m_type == TextField::STRING || field->m_type == TextField::INC_STRING)
+                    pushToken(field->m_text, lineNr, true, false);
+                else
+                    pushWord(field->m_text, lineNr, isGlued);
+            }
+            isGlued = !isSpace;
+
+            // Strings may span several lines
+            lineNr += field->m_text.count('\n');
+        }
+        lineNr++;
+    }
+
+    m_highlighter.reset();
+}
+
+
+/**
+ * @brief Splits a word from the highlighter into names and single characters.
+ * @param isGlued   True if there is no whitespace between the word and the previous token.
+ */
+void CxxTagScanner::pushWord(QString text, int lineNr, bool isGlued)
+{
+    int startIdx = 0;
+    while(startIdx < text.size())
+    {
+        int endIdx = startIdx+1;
+        QChar c = text[startIdx];
+
+        // A name (or a destructor name)?
+        if(isNameChar(c) || (c == '~' && endIdx < text.size() && isNameChar(text[endIdx])))
+        {
+            while(endIdx < text.size() && isNameChar(text[endIdx]))
+                endIdx++;
+        }
+        pushToken(text.mid(startIdx, endIdx-startIdx), lineNr, false, (isGlued || startIdx > 0) ? true : false);
+        startIdx = endIdx;
+    }
+}
+
+
+void CxxTagScanner::pushToken(QString text, int lineNr, bool isString, bool isGlued)
+{
+    // Join ':' and ':' into '::'
+    if(!isString && isGlued && text == ":" &&
+        !m_tokens.isEmpty() && !m_tokens.last().m_isString && m_tokens.last().m_text == ":")
+    {
+        m_tokens.last().m_text = "::";
+        return;
+    }
+    m_tokens.append(Token(text, lineNr, isString));
+}
+
+
+/**
+ * @brief Returns the text of a token in the current statement.
+ * @return The text or an empty string if the index is out of range.
+ */
+QString CxxTagScanner::getTokenText(int stmtIdx) const
+{
+    if(stmtIdx < 0 || stmtIdx >= m_stmt.size())
+        return "";
+    return m_tokens[m_stmt[stmtIdx]].m_text;
+}
+
+
+/**
+ * @brief Checks if a token is a name that can be tagged.
+ */
+bool CxxTagScanner::isIdentifier(QString text) const
+{
+    if(text.isEmpty())
+        return false;
+    if(!isNameChar(text[0]) && !(text[0] == '~' && text.size() > 1))
+        return false;
+    if(text[0].isDigit())
+        return false;
+    if(m_reserved.contains(text))
+        return false;
+    return true;
+}
+
+
+/**
+ * @brief Returns the index of the first token in the statement after any
+ * template declaration or attributes.
+ */
+int CxxTagScanner::getStatementStart() const
+{
+    int idx = 0;
+    bool found;
+    do
+    {
+        found = false;
+        QString openText;
+        QString closeText;
+        if(getTokenText(idx) == "template" && getTokenText(idx+1) == "<")
+        {
+            openText = "<";
+            closeText = ">";
+            idx++;
+        }
+        else if(getTokenText(idx) == "[" && getTokenText(idx+1) == "[")
+        {
+            openText = "[";
+            closeText = "]";
+        }
+
+        if(!openText.isEmpty())
+        {
+            int depth = 0;
+            for(;idx < m_stmt.size();idx++)
+            {
+                QString text = getTokenText(idx);
+                if(text == openText)
+                    depth++;
+                else if(text == closeText && --depth == 0)
+                    break;
+            }
+            idx++;
+            found = true;
+        }
+    } while(found);
+    return idx;
+}
+
+
+/**
+ * @brief Finds a token in the current statement which is not inside parentheses.
+ * @return The index in the statement or -1 if not found.
+ */
+int CxxTagScanner::findStatementToken(QString text) const
+{
+    int depth = 0;
+    for(int i = getStatementStart();i < m_stmt.size();i++)
+    {
+        QString tokText = getTokenText(i);
+        if(depth == 0 && tokText == text)
+            return i;
+        if(tokText == "(")
+            depth++;
+        else if(tokText == ")")
+            depth--;
+    }
+    return -1;
+}
+
+
+/**
+ * @brief Returns the index of the '(' that matches a ')' in the statement.
+ */
+int CxxTagScanner::findMatchingParen(int closeIdx) const
+{
+    int depth = 0;
+    for(int i = closeIdx;i >= 0;i--)
+    {
+        QString text = getTokenText(i);
+        if(text == ")")
+            depth++;
+        else if(text == "(" && --depth == 0)
+            return i;
+    }
+    return -1;
+}
+
+
+/**
+ * @brief Checks if the statement is a access specifier (Eg: "public slots").
+ */
+bool CxxTagScanner::isAccessSpecifier() const
+{
+    if(m_scopes.isEmpty() || m_scopes.last().m_type != Scope::CLASS || m_stmt.isEmpty())
+        return false;
+    for(int i = 0;i < m_stmt.size();i++)
+    {
+        QString text = getTokenText(i);
+        if(text != "public" && text != "protected" && text != "private" &&
+            text != "signals" && text != "slots" && text != "Q_SIGNALS" && text != "Q_SLOTS")
+            return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Returns the names of the namespaces and classes the parser is in (Eg: "ns::MyClass").
+ */
+QString CxxTagScanner::getScopeName() const
+{
+    QString name;
+    for(int i = 0;i < m_scopes.size();i++)
+    {
+        const Scope &scope = m_scopes[i];
+        if(scope.m_type != Scope::BLOCK && !scope.m_name.isEmpty())
+        {
+            if(!name.isEmpty())
+                name += "::";
+            name += scope.m_name;
+        }
+    }
+    return name;
+}
+
+
+/**
+ * @brief Returns the class name to use for a tag.
+ * @param qualifier   The qualifier written before the name (Eg: "MyClass" in "MyClass::func").
+ */
+QString CxxTagScanner::getClassName(QString qualifier) const
+{
+    QString scopeName = getScopeName();
+    if(!qualifier.isEmpty())
+        return scopeName.isEmpty() ? qualifier : scopeName + "::" + qualifier;
+
+    // Only members of a class gets a class name
+    for(int i = m_scopes.size()-1;i >= 0;i--)
+    {
+        if(m_scopes[i].m_type == Scope::CLASS)
+            return scopeName;
+        if(m_scopes[i].m_type == Scope::NAMESPACE)
+            return "";
+    }
+    return "";
+}
+
+
+/**
+ * @brief Returns the signature of a function (Eg: "(int a, char *b)").
+ */
+QString CxxTagScanner::getSignature(int openIdx, int closeIdx) const
+{
+    QString signature;
+    bool prevIsWord = false;
+    QString prevText;
+    for(int i = openIdx;i <= closeIdx;i++)
+    {
+        QString text = getTokenText(i);
+        bool isWord = isNameChar(text[0]);
+        if(prevText == "," || text == "=" || prevText == "=")
+            signature += " ";
+        else if(isWord && prevIsWord)
+            signature += " ";
+        else if((text == "*" || text == "&") && (prevIsWord || prevText == ">"))
+            signature += " ";
+        signature += text;
+
+        prevText = text;
+        prevIsWord = isWord;
+    }
+    return signature;
+}
+
+
+/**
+ * @brief Skips all tokens until the '}' that matches the current '{'.
+ */
+void CxxTagScanner::skipBlock()
+{
+    int depth = 0;
+    for(;m_tokenIdx < m_tokens.size();m_tokenIdx++)
+    {
+        const Token &tok = m_tokens[m_tokenIdx];
+        if(tok.m_isString)
+            continue;
+        if(tok.m_text == "{")
+            depth++;
+        else if(tok.m_text == "}" && --depth == 0)
+            return;
+    }
+}
+
+
+void CxxTagScanner::parse(QList<Tag> *taglist)
+{
+    int parenDepth = 0;
+
+    m_stmt.clear();
+    m_scopes.clear();
+    m_skipStmt = false;
+    for(m_tokenIdx = 0;m_tokenIdx < m_tokens.size();m_tokenIdx++)
+    {
+        const Token &tok = m_tokens[m_tokenIdx];
+        if(tok.m_isString)
+            m_stmt.append(m_tokenIdx);
+        else if(tok.m_text == "{")
+        {
+            // A block inside parentheses (Eg: a lambda as argument)?
+            if(parenDepth > 0)
+                skipBlock();
+            else
+                onBlockStart(taglist);
+        }
+        else if(tok.m_text == "}")
+        {
+            if(!m_scopes.isEmpty())
+            {
+                // Ignore any variables declared after a class definition
+                m_skipStmt = (m_scopes.last().m_type == Scope::CLASS) ? true : false;
+                m_scopes.pop_back();
+            }
+            m_stmt.clear();
+            parenDepth = 0;
+        }
+        else if(tok.m_text == ";" && parenDepth == 0)
+        {
+            if(!m_skipStmt)
+                onDeclaration(taglist);
+            m_skipStmt = false;
+            m_stmt.clear();
+        }
+        else if(tok.m_text == ":" && parenDepth == 0 && isAccessSpecifier())
+            m_stmt.clear();
+        else
+        {
+            if(tok.m_text == "(")
+                parenDepth++;
+            else if(tok.m_text == ")" && parenDepth > 0)
+                parenDepth--;
+            m_stmt.append(m_tokenIdx);
+        }
+    }
+}
+
+
+/**
+ * @brief Handles a '{' outside of any function.
+ */
+void CxxTagScanner::onBlockStart(QList<Tag> *taglist)
+{
+    if(m_skipStmt)
+    {
+        skipBlock();
+        return;
+    }
+
+    int startIdx = getStatementStart();
+    QString first = getTokenText(startIdx);
+    int eqIdx = findStatementToken("=");
+    int parenIdx = findStatementToken("(");
+
+    if(first == "namespace")
+    {
+        QString name;
+        for(int i = startIdx+1;i < m_stmt.size();i++)
+            name += getTokenText(i);
+        m_scopes.append(Scope(Scope::NAMESPACE, name));
+        m_stmt.clear();
+    }
+    // extern "C" { ... } ?
+    else if(first == "extern" && startIdx+2 == m_stmt.size() && m_tokens[m_stmt[startIdx+1]].m_isString)
+    {
+        m_scopes.append(Scope(Scope::BLOCK, ""));
+        m_stmt.clear();
+    }
+    else if(first == "typedef" || findStatementToken("enum") != -1)
+    {
+        skipBlock();
+        m_skipStmt = true;
+    }
+    else if(findStatementToken("operator") != -1 ||
+            (parenIdx != -1 && (eqIdx == -1 || parenIdx < eqIdx)))
+    {
+        parseFunction(taglist);
+        skipBlock();
+        m_stmt.clear();
+    }
+    else if(eqIdx != -1)
+    {
+        // Initializer (Eg: "int a[] = {1,2};")
+        skipBlock();
+    }
+    else if(first == "class" || first == "struct" || first == "union")
+    {
+        // Get the name (the last name before any base class list)
+        QString name;
+        int lineNr = 0;
+        int angleDepth = 0;
+        for(int i = startIdx+1;i < m_stmt.size();i++)
+        {
+            QString text = getTokenText(i);
+            if(text == ":")
+                break;
+            if(text == "<")
+                angleDepth++;
+            else if(text == ">")
+                angleDepth--;
+            else if(angleDepth == 0 && isIdentifier(text))
+            {
+                name = text;
+                lineNr = m_tokens[m_stmt[i]].m_lineNr;
+            }
+        }
+
+        if(name.isEmpty())
+        {
+            // Members of anonymous structs are not tagged
+            skipBlock();
+            m_skipStmt = true;
+        }
+        else
+        {
+            debugMsg("Found class '%s' at L%d", qPrintable(name), lineNr);
+            Tag tag;
+            tag.m_name = name;
+            tag.m_className = getClassName("");
+            tag.m_filepath = m_filepath;
+            tag.m_type = Tag::TAG_VARIABLE;
+            tag.setLineNo(lineNr);
+            taglist->append(tag);
+
+            m_scopes.append(Scope(Scope::CLASS, name));
+            m_stmt.clear();
+        }
+    }
+    else
+    {
+        // Unknown block (Eg: "int a{0};")
+        skipBlock();
+    }
+}
+
+
+/**
+ * @brief Parses a function definition (the statement before the '{').
+ */
+void CxxTagScanner::parseFunction(QList<Tag> *taglist)
+{
+    int startIdx = getStatementStart();
+    int endIdx = m_stmt.size();
+
+    // Remove any constructor initializer list or trailing return type
+    int depth = 0;
+    bool foundParen = false;
+    for(int i = startIdx;i < m_stmt.size() && endIdx == m_stmt.size();i++)
+    {
+        QString text = getTokenText(i);
+        if(text == "(")
+            depth++;
+        else if(text == ")")
+        {
+            if(--depth == 0)
+                foundParen = true;
+        }
+        else if(depth == 0 && foundParen &&
+            (text == ":" || (text == "-" && getTokenText(i+1) == ">")))
+            endIdx = i;
+    }
+
+    // Find the parameter list by skipping qualifiers after it
+    int closeIdx = endIdx-1;
+    int openIdx = -1;
+    while(closeIdx > startIdx && openIdx == -1)
+    {
+        QString text = getTokenText(closeIdx);
+        if(text == ")")
+        {
+            int matchIdx = findMatchingParen(closeIdx);
+            if(matchIdx <= startIdx)
+                return;
+            QString prevText = getTokenText(matchIdx-1);
+            if(prevText == "noexcept" || prevText == "throw" || prevText == "__attribute__")
+                closeIdx = matchIdx-2;
+            else
+                openIdx = matchIdx;
+        }
+        else if(text == "const" || text == "volatile" || text == "override" ||
+                text == "final" || text == "noexcept" || text == "&")
+            closeIdx--;
+        // A macro (Eg: "Q_DECL_OVERRIDE")?
+        else if(isIdentifier(text) && text == text.toUpper())
+            closeIdx--;
+        else
+            return;
+    }
+    if(openIdx == -1)
+        return;
+
+    // Get the name
+    QString name;
+    int nameIdx = openIdx-1;
+    int operatorIdx = -1;
+    for(int i = nameIdx;i >= startIdx && i >= nameIdx-4 && operatorIdx == -1;i--)
+    {
+        if(getTokenText(i) == "operator")
+            operatorIdx = i;
+    }
+    if(operatorIdx != -1)
+    {
+        name = "operator";
+        for(int i = operatorIdx+1;i <= nameIdx;i++)
+        {
+            QString text = getTokenText(i);
+            if(text[0].isLetter() || text[0] == '_')
+                name += " ";
+            name += text;
+        }
+        nameIdx = operatorIdx;
+    }
+    else
+    {
+        name = getTokenText(nameIdx);
+        if(!isIdentifier(name))
+            return;
+    }
+
+    // Get the qualifier (Eg: "MyClass" in "MyClass::func")
+    QString qualifier;
+    int i = nameIdx-1;
+    while(i > startIdx && getTokenText(i) == "::")
+    {
+        i--;
+
+        // Skip any template arguments (Eg: "MyClass<T>::func")
+        if(getTokenText(i) == ">")
+        {
+            int angleDepth = 0;
+            for(;i >= startIdx;i--)
+            {
+                QString text = getTokenText(i);
+                if(text == ">")
+                    angleDepth++;
+                else if(text == "<" && --angleDepth == 0)
+                    break;
+            }
+            i--;
+        }
+
+        QString part = getTokenText(i);
+        if(!isIdentifier(part))
+            break;
+        qualifier = qualifier.isEmpty() ? part : (part + "::" + qualifier);
+        i--;
+    }
+
+    Tag tag;
+    tag.m_name = name;
+    tag.m_className = getClassName(qualifier);
+    tag.m_filepath = m_filepath;
+    tag.m_type = Tag::TAG_FUNC;
+    tag.setLineNo(m_tokens[m_stmt[nameIdx]].m_lineNr);
+    tag.setSignature(getSignature(openIdx, closeIdx));
+    debugMsg("Found function '%s' at L%d", qPrintable(tag.getLongName()), tag.getLineNo());
+
+    taglist->append(tag);
+}
+
+
+/**
+ * @brief Handles a statement ending with ';' outside of any function.
+ *
+ * Tags the variables declared in it. Function prototypes are ignored.
+ */
+void CxxTagScanner::onDeclaration(QList<Tag> *taglist)
+{
+    int startIdx = getStatementStart();
+    if(startIdx >= m_stmt.size())
+        return;
+
+    // Not a variable declaration?
+    QString first = getTokenText(startIdx);
+    if(first == "typedef" || first == "using" || first == "friend" || first == "extern" ||
+        first == "namespace" || first == "enum" || first == "static_assert" || first == "template")
+        return;
+    if((first == "class" || first == "struct" || first == "union") && m_stmt.size()-startIdx <= 2)
+        return;
+    if(findStatementToken("operator") != -1)
+        return;
+    int eqIdx = findStatementToken("=");
+    int parenIdx = findStatementToken("(");
+    if(parenIdx != -1 && (eqIdx == -1 || parenIdx < eqIdx))
+        return;
+
+    // Tag each declarator (Eg: "a" and "b" in "int a = 1, b;")
+    QString className = getClassName("");
+    int angleDepth = 0;
+    int parenDepth = 0;
+    bool inInit = false;
+    bool isFirst = true;
+    int tokenCount = 0;
+    int nameIdx = -1;
+    for(int i = startIdx;i <= m_stmt.size();i++)
+    {
+        QString text = getTokenText(i);
+        if(i == m_stmt.size() ||
+            (text == "," && parenDepth == 0 && (inInit || angleDepth == 0)))
+        {
+            // The first declarator must have a type before the name
+            if(nameIdx != -1 && (!isFirst || tokenCount > 1))
+            {
+                Tag tag;
+                tag.m_name = getTokenText(nameIdx);
+                tag.m_className = className;
+                tag.m_filepath = m_filepath;
+                tag.m_type = Tag::TAG_VARIABLE;
+                tag.setLineNo(m_tokens[m_stmt[nameIdx]].m_lineNr);
+                taglist->append(tag);
+            }
+            isFirst = false;
+            inInit = false;
+            angleDepth = 0;
+            tokenCount = 0;
+            nameIdx = -1;
+            continue;
+        }
+
+        if(text == "(")
+            parenDepth++;
+        else if(text == ")")
+            parenDepth--;
+        if(inInit || parenDepth > 0)
+            continue;
+
+        tokenCount++;
+        if(text == "=" || text == "[" || text == ":")
+            inInit = true;
+        else if(text == "<")
+            angleDepth++;
+        else if(text == ">")
+            angleDepth--;
+        else if(angleDepth == 0 && isIdentifier(text))
+            nameIdx = i;
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2014-2020 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__CXXTAGSCANNER_H
+#define FILE__CXXTAGSCANNER_H
+
+#include <QVector>
+#include <QHash>
+
+#include "tagscanner.h"
+#include "syntaxhighlightercxx.h"
+
+
+/**
+ * @brief Tag scanner for the C and C++ languages.
+ *
+ * Used when no ctags executable is available. The file is split into
+ * tokens with the C/C++ syntax highlighter and then parsed for function
+ * definitions, classes, class members and global variables.
+ * Function bodies are skipped without being parsed.
+ */
+class CxxTagScanner
+{
+public:
+
+    CxxTagScanner();
+    virtual ~CxxTagScanner();
+
+    int scan(QString filepath, QList<Tag> *taglist);
+
+    void setConfig(Settings *cfg);
+
+    static bool isCxxFile(QString filepath);
+
+private:
+    class Token
+    {
+    public:
+        Token() : m_lineNr(0), m_isString(false) {};
+        Token(QString text, int lineNr, bool isString)
+            : m_text(text), m_lineNr(lineNr), m_isString(isString) {};
+
+        QString m_text;
+        int m_lineNr;
+        bool m_isString;
+    };
+
+    class Scope
+    {
+    public:
+        typedef enum { NAMESPACE, CLASS, BLOCK } Type;
+
+        Scope() : m_type(BLOCK) {};
+        Scope(Type type, QString name) : m_type(type), m_name(name) {};
+
+        Type m_type;
+        QString m_name;
+    };
+
+    void tokenize(QString text);
+    void pushToken(QString text, int lineNr, bool isString, bool isGlued);
+    void pushWord(QString text, int lineNr, bool isGlued);
+
+    void parse(QList<Tag> *taglist);
+    void onBlockStart(QList<Tag> *taglist);
+    void onDeclaration(QList<Tag> *taglist);
+    void parseFunction(QList<Tag> *taglist);
+    void skipBlock();
+
+    int getStatementStart() const;
+    int findStatementToken(QString text) const;
+    int findMatchingParen(int closeIdx) const;
+    QString getTokenText(int stmtIdx) const;
+    bool isIdentifier(QString text) const;
+    bool isAccessSpecifier() const;
+    QString getScopeName() const;
+    QString getClassName(QString qualifier) const;
+    QString getSignature(int openIdx, int closeIdx) const;
+
+private:
+    Settings *m_cfg;
+    SyntaxHighlighterCxx m_highlighter;
+    QHash <QString, bool> m_reserved; //!< Words that can not be used as a name.
+    QString m_filepath;
+
+    QVector<Token> m_tokens;
+    int m_tokenIdx; //!< Current position in m_tokens while parsing.
+    QVector<int> m_stmt; //!< Indexes (in m_tokens) of the statement being parsed.
+    bool m_skipStmt; //!< Ignore the current statement.
+    QVector<Scope> m_scopes;
+};
+
+#endif // FILE__CXXTAGSCANNER_H
@@ -14,6 +14,9 @@
 #endif
 
 #include <QMessageBox>
+#include <QPushButton>
+#include <QProcess>
+#include <QFileInfo>
 #include <QDir>
 
 #include "mainwindow.h"
@@ -66,17 +69,84 @@ static int dumpVersion()
  */
 void loadBreakpoints(Settings &cfg, Core &core)
 {
-    for(int i = 0;i < cfg.m_breakpoints.size();i++)
+    debugMsg("Setting %d breakpoints", cfg.m_breakpoints.size());
+    core.gdbSetBreakpoints(cfg.m_breakpoints);
+}
+
+
+
+/**
+ * @brief Checks if the program has a symbol index and offers to generate one if not.
+ *
+ * Without a .gdb_index or .debug_names section gdb has to read all debug
+ * info to build its own index each time the program is loaded.
+ */
+static void checkSymbolIndex(Settings &cfg)
+{
+    QString programPath = cfg.getProgramPath();
+    QStringList sectionNames;
+    if(getElfSectionNames(programPath, &sectionNames))
+        return;
+
+    if(sectionNames.contains(".gdb_index"))
+    {
+        infoMsg("'%s' has a symbol index (.gdb_index)", stringToCStr(programPath));
+        return;
+    }
+    if(sectionNames.contains(".debug_names"))
+    {
+        infoMsg("'%s' has a symbol index (.debug_names)", stringToCStr(programPath));
+        return;
+    }
+
+    // No debug info in the file (Eg: in a separate debug file)?
+    if(!sectionNames.contains(".debug_info"))
+        return;
+
+    infoMsg("'%s' has no symbol index (.gdb_index or .debug_names)", stringToCStr(programPath));
+
+    if(!cfg.m_askToAddSymbolIndex || !exeExists("gdb-add-index") || !QFileInfo(programPath).isWritable())
+        return;
+
+    QMessageBox msgBox;
+    msgBox.setWindowTitle("No symbol index");
+    msgBox.setIcon(QMessageBox::Question);
+    msgBox.setText("'" + programPath + "' has no symbol index.\n"
+                   "Generating one with gdb-add-index makes the symbols load faster.");
+    QPushButton *generateButton = msgBox.addButton("Generate", QMessageBox::AcceptRole);
+    msgBox.addButton("Not now", QMessageBox::RejectRole);
+    QPushButton *neverButton = msgBox.addButton("Never ask for this project", QMessageBox::DestructiveRole);
+    msgBox.exec();
+
+    if(msgBox.clickedButton() == neverButton)
+    {
+        cfg.m_askToAddSymbolIndex = false;
+        cfg.save();
+    }
+    else if(msgBox.clickedButton() == generateButton)
     {
-        SettingsBreakpoint bkptCfg = cfg.m_breakpoints[i];
-        debugMsg("Setting breakpoint at %s:L%d", qPrintable(bkptCfg.m_filename), bkptCfg.m_lineNo);
-	if (core.findBreakPoint(bkptCfg.m_filename, bkptCfg.m_lineNo) == NULL)
-	  // insert only if not already there
-	  core.gdbSetBreakpoint(bkptCfg.m_filename, bkptCfg.m_lineNo);
+        // Run gdb-add-index (with the same gdb as used for debugging)
+        QProcess process;
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert("GDB", cfg.m_gdbPath);
+        process.setProcessEnvironment(env);
+        process.setProcessChannelMode(QProcess::MergedChannels);
+
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        process.start("gdb-add-index", QStringList() << programPath);
+        bool finished = process.waitForFinished(-1);
+        QApplication::restoreOverrideCursor();
+
+        if(!finished || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+        {
+            QString output = QString::fromLocal8Bit(process.readAll()).trimmed();
+            errorMsg("Failed to add a symbol index to '%s' (%s)", stringToCStr(programPath), stringToCStr(output));
+        }
+        else
+            infoMsg("Added a symbol index to '%s'", stringToCStr(programPath));
     }
 }
 
-    
 
 /**
  * @brief Main program entry.
@@ -199,8 +269,18 @@ int main(int argc, char *argv[])
     Core &core = Core::getInstance();
 
     
+    checkSymbolIndex(cfg);
+
     MainWindow w(NULL);
 
+    // Show the window while gdb loads the program
+    if(cfg.m_loadSymbolsInBackground)
+    {
+        w.show();
+        w.setSymbolsLoading(true);
+        app.processEvents();
+    }
+
     if(cfg.m_connectionMode == MODE_LOCAL)
         rc = core.initLocal(&cfg, cfg.m_gdbPath, cfg.getProgramPath(), cfg.m_argumentList);
     else if(cfg.m_connectionMode == MODE_SERIAL)
@@ -212,6 +292,14 @@ int main(int argc, char *argv[])
     else
         rc = core.initRemote(&cfg, cfg.m_gdbPath, cfg.getProgramPath(), cfg.m_tcpHost, cfg.m_tcpPort);
 
+    if(cfg.m_loadSymbolsInBackground)
+    {
+        // Closed while loading?
+        if(!w.isVisible())
+            return 0;
+        w.setSymbolsLoading(false);
+    }
+
     if(rc)
         return rc;
 
@@ -64,9 +64,36 @@ HEADERS+=settings.h
 SOURCES+=tagscanner.cpp tagmanager.cpp
 HEADERS+=tagscanner.h   tagmanager.h
 
+SOURCES+=symbolindex.cpp
+HEADERS+=symbolindex.h
+
+SOURCES+=completionindex.cpp
+HEADERS+=completionindex.h
+
+SOURCES+=symbolsearchwidget.cpp
+HEADERS+=symbolsearchwidget.h
+
+SOURCES+=taglistmodel.cpp
+HEADERS+=taglistmodel.h
+
+SOURCES+=sourcetreemodel.cpp
+HEADERS+=sourcetreemodel.h
+
+SOURCES+=breakpointsaver.cpp
+HEADERS+=breakpointsaver.h
+
+SOURCES+=threadlistmodel.cpp
+HEADERS+=threadlistmodel.h
+
+SOURCES+=stackframemodel.cpp
+HEADERS+=stackframemodel.h
+
 SOURCES+=rusttagscanner.cpp
 HEADERS+=rusttagscanner.h
 
+SOURCES+=cxxtagscanner.cpp
+HEADERS+=cxxtagscanner.h
+
 HEADERS+=config.h
 
 SOURCES+=varctl.cpp watchvarctl.cpp autovarctl.cpp
@@ -21,8 +21,6 @@
 #include "config.h"
 
 
-#define MAX_TAGS   2000
-
 
 GoToDialog::GoToDialog(QWidget *parent, Locator *locator, Settings *cfg, QString currentFilename)
     : QDialog(parent)
@@ -163,15 +161,18 @@ void GoToDialog::onComboBoxTabKey()
             }
         }
 
+        QString curText = getTextLeftToCursor(m_ui.comboBox);
+
+        // Split the entered text into fields
+        QStringList fields = curText.split(" ");
+
+        // The suggestions are fuzzy matches so they may not start with the entered text
+        if(!fields.isEmpty() && !commonText.startsWith(fields.last()))
+            commonText.clear();
+
         // User pressed 'tab' when there entries with a common beginning
         if(!commonText.isEmpty())
         {
-
-            QString curText = getTextLeftToCursor(m_ui.comboBox);
-
-            // Split the entered text into fields
-            QStringList fields = curText.split(" ");
-            
             // Replace the last part with the common beginning from the listwidget
             if(fields.size() == 0)
                 fields.append(commonText);
@@ -343,22 +344,21 @@ void GoToDialog::onSearchTextEdited ( const QString & text2 )
     }
     expr = expList.last();
         
-    // Ask the locator for files and tags that match
+    // Ask the locator for files and tags that match (best match first)
     QStringList exprList;
     if(showSuggestion == SHOW_FUNC_AND_FILE)
-        exprList = m_locator->searchExpression(expr);
+        exprList = m_locator->searchExpression(expr, GOTO_MAX_SUGGESTIONS);
     else if(showSuggestion == SHOW_FUNC)
-        exprList = m_locator->searchExpression(expList[0], expr);
+        exprList = m_locator->searchExpression(expList[0], expr, GOTO_MAX_SUGGESTIONS);
     
     // Add the found ones to to the list
-    for(int i = 0;i < qMin(exprList.size(), MAX_TAGS);i++)
+    for(int i = 0;i < exprList.size();i++)
     {
         QString fieldText = exprList[i];
         QListWidgetItem *item = new QListWidgetItem(fieldText);
         item->setSizeHint(QSize(GOTO_LISTWIDGET_ITEM_WIDTH,20));
         m_ui.listWidget->addItem(item);
     }
-    m_ui.listWidget->sortItems(Qt::AscendingOrder);
 
     if(showSuggestion == SHOW_NONE)
         showListWidget(false);
@@ -9,6 +9,9 @@
 #include "ini.h"
 
 #include <QFile>
+#if QT_VERSION >= QT_VERSION_CHECK(5,1,0)
+#include <QSaveFile>
+#endif
 #include <QStringList>
 #include <assert.h>
 #include <QtDebug>
@@ -450,11 +453,19 @@ static bool compareEntry(const IniEntry* s1, const IniEntry* s2)
 
 /**
  * @brief Saves the content to a ini file.
+ *
+ * The content is written to a temporary file which then replaces the
+ * old file. A reader will never see a partially written file.
  * @return 0 on success.
  */
 int Ini::save(QString filename)
 {
-    QFile file(filename);
+#if QT_VERSION >= QT_VERSION_CHECK(5,1,0)
+    QSaveFile file(filename);
+#else
+    QString tmpFilename = filename + ".tmp";
+    QFile file(tmpFilename);
+#endif
     if (!file.open(QIODevice::Truncate | QIODevice::WriteOnly | QIODevice::Text))
         return 1;
 
@@ -500,7 +511,15 @@ int Ini::save(QString filename)
         file.write("\r\n");
 
     }
+#if QT_VERSION >= QT_VERSION_CHECK(5,1,0)
+    if(!file.commit())
+        return 1;
+#else
     file.close();
+    QFile::remove(filename);
+    if(!QFile::rename(tmpFilename, filename))
+        return 1;
+#endif
     return 0;
 }
 
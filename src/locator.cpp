@@ -17,6 +17,7 @@
 #include "core.h"
 #include "mainwindow.h"
 #include "qtutil.h"
+#include "config.h"
 
 
 Location::Location(QString filename_, int lineNo_)
@@ -34,6 +35,8 @@ void Location::dump()
 Locator::Locator(TagManager *mgr, QList<FileInfo> *sourceFiles)
     : m_mgr(mgr)
     ,m_sourceFiles(sourceFiles)
+    ,m_completionIndexRevision(-1)
+    ,m_fileCompletionRevision(-1)
 {
 }
 
@@ -128,75 +131,100 @@ QStringList Locator::findFile(QString defFilename)
     return fileList;
 }
 
-QStringList Locator::searchExpression(QString filename, QString expressionStart)
+/**
+ * @brief Must be called when the list of sourcefiles has changed.
+ */
+void Locator::onSourceFilesChanged()
 {
-    debugMsg("%s('%s', '%s')", __func__, qPrintable(filename), qPrintable(expressionStart));
-    
+    m_completionIndexRevision = -1;
+    m_fileCompletionRevision = -1;
+}
+
+
+/**
+ * @brief Rebuilds the list of filenames and functions if any tags has changed.
+ *
+ * While the files are being scanned the tags changes all the time so the
+ * list is then rebuilt at most once per GOTO_INDEX_UPDATE_INTERVAL.
+ */
+void Locator::updateCompletionIndex()
+{
+    const SymbolIndex &index = m_mgr->getIndex();
+    if(m_completionIndexRevision == index.getRevision())
+        return;
+    if(m_completionIndexRevision != -1 && m_completionIndexTimer.elapsed() < GOTO_INDEX_UPDATE_INTERVAL)
+        return;
+    m_completionIndexRevision = index.getRevision();
+    m_completionIndexTimer.start();
+
     QStringList list;
     for(int k = 0;k < m_sourceFiles->size();k++)
     {
         FileInfo &info = (*m_sourceFiles)[k];
+        list.append(info.m_name);
 
-        
-        if(info.m_name != filename)
-            continue;
-            
-        // Find the tag
-        QList<Tag> tagList;
-        m_mgr->getTags(info.m_fullName, &tagList);
-        for(int i = 0;i < tagList.size();i++)
+        QVector<SymbolIndex::TagId> idList = index.getFileTags(info.m_fullName);
+        for(int i = 0;i < idList.size();i++)
         {
-            Tag &tag = tagList[i];
+            const Tag &tag = index.getTag(idList[i]);
             if(tag.m_type == Tag::TAG_FUNC)
-            {
-                QString tagName = tag.getName() + "()";
-                if(tagName.startsWith(expressionStart) || expressionStart.isEmpty())
-                {
-                    debugMsg("Found '%s'", qPrintable(tagName));
-                    list.append(tagName);
-                }
-            }
+                list.append(SymbolIndex::getQualifiedName(tag) + "()");
         }
     }
-    return list;
+    m_completionIndex.setList(list);
 }
 
 
-QStringList Locator::searchExpression(QString expressionStart)
+/**
+ * @brief Returns the functions in a file that matches a text.
+ * @param filename          Name of the file (Eg: "main.c").
+ * @param expressionStart   Text entered by the user.
+ */
+QStringList Locator::searchExpression(QString filename, QString expressionStart, int maxCount)
 {
+    debugMsg("%s('%s', '%s')", __func__, qPrintable(filename), qPrintable(expressionStart));
+    
+    // Same file and tags as the last time?
+    const SymbolIndex &index = m_mgr->getIndex();
+    if(m_fileCompletionName == filename && m_fileCompletionRevision == index.getRevision())
+        return m_fileCompletionIndex.find(expressionStart, maxCount);
+    m_fileCompletionName = filename;
+    m_fileCompletionRevision = index.getRevision();
+
     QStringList list;
     for(int k = 0;k < m_sourceFiles->size();k++)
     {
         FileInfo &info = (*m_sourceFiles)[k];
-        if(info.m_name.startsWith(expressionStart))
-            list.append(info.m_name);
-
 
+        
+        if(info.m_name != filename)
+            continue;
+            
         // Find the tag
-        QList<Tag> tagList;
-        m_mgr->getTags(info.m_fullName, &tagList);
-        for(int i = 0;i < tagList.size();i++)
+        QVector<SymbolIndex::TagId> idList = index.getFileTags(info.m_fullName);
+        for(int i = 0;i < idList.size();i++)
         {
-            Tag &tag = tagList[i];
+            const Tag &tag = index.getTag(idList[i]);
             if(tag.m_type == Tag::TAG_FUNC)
-            {
-            QString tagName;
-            if(tag.isClassMember())
-                tagName = tag.getClassName() + "::" + tag.getName();
-            else
-                tagName = tag.getName();
-            tagName += "()";
-            
-            if(tagName.startsWith(expressionStart))
-            {
-                debugMsg("Found '%s'", qPrintable(tagName));
-                list.append(tagName);
-            }
-            }
+                list.append(tag.getName() + "()");
         }
     }
-                
-    return list;
+
+    m_fileCompletionIndex.setList(list);
+    return m_fileCompletionIndex.find(expressionStart, maxCount);
+}
+
+
+/**
+ * @brief Returns the filenames and functions that best matches a text.
+ * @param expressionStart   Text entered by the user.
+ * @param maxCount          Max number of entries to return.
+ */
+QStringList Locator::searchExpression(QString expressionStart, int maxCount)
+{
+    updateCompletionIndex();
+
+    return m_completionIndex.find(expressionStart, maxCount, GOTO_SEARCH_TIME_LIMIT);
 }
     
 
@@ -334,23 +362,12 @@ QVector<Location> Locator::locate(QString expr)
 QVector<Location> Locator::locateFunction(QString name)
 {
     QVector<Location> list;
-    for(int k = 0;k < m_sourceFiles->size();k++)
+    QList<Tag> tagList;
+    m_mgr->lookupFunction(name, &tagList);
+    for(int i = 0;i < tagList.size();i++)
     {
-        FileInfo &info = (*m_sourceFiles)[k];
-
-        // Find the tag
-        QList<Tag> tagList;
-        m_mgr->getTags(info.m_fullName, &tagList);
-        for(int i = 0;i < tagList.size();i++)
-        {
-            Tag &tag = tagList[i];
-            if(tag.m_type == Tag::TAG_FUNC && tag.getName() == name)
-            {
-                list.append(Location(tag.getFilePath(), tag.getLineNo()));
-            }
-            
-        }
+        Tag &tag = tagList[i];
+        list.append(Location(tag.getFilePath(), tag.getLineNo()));
     }
     return list;
 }
- 
@@ -3,8 +3,10 @@
 
 #include <QString>
 #include <QVector>
+#include <QElapsedTimer>
 
 #include "tagmanager.h"
+#include "completionindex.h"
 
 class Location
 {
@@ -29,17 +31,28 @@ public:
     QVector<Location> locate(QString expr);
     QVector<Location> locateFunction(QString name);
 
-    QStringList searchExpression(QString expressionStart);
+    void onSourceFilesChanged();
+
+    QStringList searchExpression(QString expressionStart, int maxCount);
      
-    QStringList searchExpression(QString filename, QString expressionStart);
+    QStringList searchExpression(QString filename, QString expressionStart, int maxCount);
 
 private:
     QStringList findFile(QString defFilename);
+    void updateCompletionIndex();
     
 public:
     TagManager *m_mgr;
     QString m_currentFilename;
     QList<FileInfo> *m_sourceFiles;
+
+private:
+    CompletionIndex m_completionIndex; //!< Filenames and functions
+    int m_completionIndexRevision; //!< Revision of the tag index used for m_completionIndex
+    QElapsedTimer m_completionIndexTimer; //!< Time since m_completionIndex was built
+    CompletionIndex m_fileCompletionIndex; //!< Functions in m_fileCompletionName
+    QString m_fileCompletionName; //!< The file that m_fileCompletionIndex is for
+    int m_fileCompletionRevision; //!< Revision of the tag index used for m_fileCompletionIndex
 };
 
 #endif // FILE__LOCATOR_H
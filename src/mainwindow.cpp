@@ -14,11 +14,14 @@
 #include <QMessageBox>
 #include <QScrollBar>
 #include <QFileInfo>
+#include <QInputDialog>
+#include <limits.h>
 
 #include <assert.h>
 
 #include "util.h"
 #include "log.h"
+#include "config.h"
 #include "core.h"
 #include "aboutdialog.h"
 #include "settingsdialog.h"
@@ -31,6 +34,7 @@
 
 MainWindow::MainWindow(QWidget *parent)
       : QMainWindow(parent)
+      ,m_sourceFileGeneration(0)
       ,m_tagManager(m_cfg)
       ,m_locator(&m_tagManager, &m_sourceFiles)
 {
@@ -48,54 +52,82 @@ MainWindow::MainWindow(QWidget *parent)
 
 
     //
-    m_ui.treeWidget_breakpoints->setColumnCount(4);
-    m_ui.treeWidget_breakpoints->setColumnWidth(0, 120);
-    m_ui.treeWidget_breakpoints->setColumnWidth(1, 40);
-    m_ui.treeWidget_breakpoints->setColumnWidth(2, 200);
-    m_ui.treeWidget_breakpoints->setColumnWidth(3, 140);
+    m_ui.treeWidget_breakpoints->setColumnCount(BKPT_COLUMN_COUNT);
+    m_ui.treeWidget_breakpoints->setColumnWidth(BKPT_COLUMN_FILENAME, 120);
+    m_ui.treeWidget_breakpoints->setColumnWidth(BKPT_COLUMN_LINE, 40);
+    m_ui.treeWidget_breakpoints->setColumnWidth(BKPT_COLUMN_FUNC, 200);
+    m_ui.treeWidget_breakpoints->setColumnWidth(BKPT_COLUMN_ADDR, 140);
+    m_ui.treeWidget_breakpoints->setColumnWidth(BKPT_COLUMN_HITS, 80);
+    m_ui.treeWidget_breakpoints->setColumnWidth(BKPT_COLUMN_CONDITION, 140);
+    m_ui.treeWidget_breakpoints->setColumnWidth(BKPT_COLUMN_ENABLED, 60);
     names.clear();
     names += "Filename";
     names += "Line";
     names += "Func";
     names += "Addr";
+    names += "Hits";
+    names += "Condition";
+    names += "Enabled";
     m_ui.treeWidget_breakpoints->setHeaderLabels(names);
     connect(m_ui.treeWidget_breakpoints, SIGNAL(itemDoubleClicked ( QTreeWidgetItem * , int  )), this, SLOT(onBreakpointsWidgetItemDoubleClicked(QTreeWidgetItem * ,int)));
     connect(m_ui.treeWidget_breakpoints, SIGNAL(customContextMenuRequested(const QPoint &)), this, SLOT(onBreakpointsWidgetContextMenu(const QPoint&)));
     m_ui.treeWidget_breakpoints->setContextMenuPolicy(Qt::CustomContextMenu);
 
+    // Watchpoint log widget
+    m_ui.treeWidget_watchpointLog->setColumnCount(6);
+    m_ui.treeWidget_watchpointLog->setColumnWidth(0, 120);
+    m_ui.treeWidget_watchpointLog->setColumnWidth(1, 80);
+    m_ui.treeWidget_watchpointLog->setColumnWidth(2, 80);
+    m_ui.treeWidget_watchpointLog->setColumnWidth(3, 140);
+    m_ui.treeWidget_watchpointLog->setColumnWidth(4, 50);
+    names.clear();
+    names += "Watchpoint";
+    names += "Old";
+    names += "New";
+    names += "PC";
+    names += "Thread";
+    names += "Location";
+    m_ui.treeWidget_watchpointLog->setHeaderLabels(names);
 
 
 
 
 
-    //
-    QTreeWidget *treeWidget = m_ui.treeWidget_file;
-    treeWidget->setColumnWidth(0, 200);
+
+    // Source file tree
+    m_fileTreeModel.setIcons(m_folderIcon, m_fileIcon);
+    m_ui.treeView_file->setModel(&m_fileTreeModel);
+    m_ui.treeView_file->setColumnWidth(0, 200);
+    connect(&m_sourceFileChecker, SIGNAL(onCheckDone(int, QStringList, QStringList, QStringList, bool)),
+                SLOT(onSourceFilesChecked(int, QStringList, QStringList, QStringList, bool)));
+    m_sourceFileChecker.start();
+
+    m_breakpointSaveTimer.setSingleShot(true);
+    m_breakpointSaveTimer.setInterval(BREAKPOINT_SAVE_DELAY);
+    connect(&m_breakpointSaveTimer, SIGNAL(timeout()), SLOT(onBreakpointSaveTimeout()));
+    m_breakpointSaver.start();
 
 
     // Thread widget
-    treeWidget = m_ui.treeWidget_threads;
-    names.clear();
-    names += "Name";
-    names += "Details";
-    treeWidget->setHeaderLabels(names);
-    treeWidget->setColumnCount(2);
-    treeWidget->setColumnWidth(0, 150);
-    treeWidget->setColumnWidth(1, 100);
-
-    connect(m_ui.treeWidget_threads, SIGNAL(itemSelectionChanged()), this,
+    m_ui.treeView_threads->setModel(&m_threadListModel);
+    m_ui.treeView_threads->setColumnWidth(ThreadListModel::COLUMN_NAME, 150);
+    m_ui.treeView_threads->setColumnWidth(ThreadListModel::COLUMN_DETAILS, 100);
+
+    connect(m_ui.treeView_threads->selectionModel(), SIGNAL(selectionChanged(const QItemSelection &, const QItemSelection &)), this,
                 SLOT(onThreadWidgetSelectionChanged()));
+    connect(m_ui.treeView_threads, SIGNAL(doubleClicked(const QModelIndex &)), this,
+                SLOT(onThreadViewDoubleClicked(const QModelIndex &)));
+    connect(&m_threadListModel, SIGNAL(framesRequested(QList<int>)), this,
+                SLOT(onThreadFramesRequested(QList<int>)));
 
     // Stack widget
-    treeWidget = m_ui.treeWidget_stack;
-    names.clear();
-    names += "Name";
-    treeWidget->setHeaderLabels(names);
-    treeWidget->setColumnCount(1);
-    treeWidget->setColumnWidth(0, 200);
+    m_ui.treeView_stack->setModel(&m_stackFrameModel);
+    m_ui.treeView_stack->setColumnWidth(0, 200);
 
-    connect(m_ui.treeWidget_stack, SIGNAL(itemSelectionChanged()), this,
+    connect(m_ui.treeView_stack->selectionModel(), SIGNAL(selectionChanged(const QItemSelection &, const QItemSelection &)), this,
                 SLOT(onStackWidgetSelectionChanged()));
+    connect(&m_stackFrameModel, SIGNAL(framesRequested(int,int)), this,
+                SLOT(onStackFramesRequested(int,int)));
 
 
 
@@ -131,7 +163,7 @@ MainWindow::MainWindow(QWidget *parent)
 
      
 
-    connect(m_ui.treeWidget_file, SIGNAL(itemActivated(QTreeWidgetItem*,int)), this, SLOT(onFolderViewItemActivated(QTreeWidgetItem*,int)));
+    connect(m_ui.treeView_file, SIGNAL(activated(const QModelIndex &)), this, SLOT(onFolderViewItemActivated(const QModelIndex &)));
 
     connect(m_ui.actionQuit, SIGNAL(triggered()), SLOT(onQuit()));
     connect(m_ui.actionStop, SIGNAL(triggered()), SLOT(onStop()));
@@ -143,9 +175,14 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_ui.actionStep_Out, SIGNAL(triggered()), SLOT(onStepOut()));
     connect(m_ui.actionRestart, SIGNAL(triggered()), SLOT(onRestart()));
     connect(m_ui.actionContinue, SIGNAL(triggered()), SLOT(onContinue()));
+    connect(m_ui.actionNextMany, SIGNAL(triggered()), SLOT(onNextMany()));
+    connect(m_ui.actionNextUntil, SIGNAL(triggered()), SLOT(onNextUntil()));
+    connect(m_ui.actionContinueHits, SIGNAL(triggered()), SLOT(onContinueHits()));
 
     connect(m_ui.actionViewStack, SIGNAL(triggered()), SLOT(onViewStack()));
     connect(m_ui.actionViewBreakpoints, SIGNAL(triggered()), SLOT(onViewBreakpoints()));
+    connect(m_ui.actionViewWatchpointLog, SIGNAL(triggered()), SLOT(onViewWatchpointLog()));
+    connect(m_ui.tabWidget, SIGNAL(currentChanged(int)), SLOT(onPanelTabChanged(int)));
     connect(m_ui.actionViewThreads, SIGNAL(triggered()), SLOT(onViewThreads()));
     connect(m_ui.actionViewWatch, SIGNAL(triggered()), SLOT(onViewWatch()));
     connect(m_ui.actionViewAutoVariables, SIGNAL(triggered()), SLOT(onViewAutoVariables()));
@@ -169,11 +206,11 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(&m_tagManager, SIGNAL(onAllScansDone()), SLOT(onAllTagScansDone()));
 
-    //Setup the function treewidget
-    treeWidget = m_ui.treeWidget_functions;
-    treeWidget->setColumnWidth(0, 200);
-    connect(m_ui.treeWidget_functions, SIGNAL(itemClicked(QTreeWidgetItem * , int )),
-            SLOT(onFuncWidgetItemSelected(QTreeWidgetItem * , int )));
+    //Setup the function treeview
+    m_ui.treeView_functions->setModel(&m_funcListModel);
+    m_ui.treeView_functions->setColumnWidth(TagListModel::COLUMN_NAME, 200);
+    connect(m_ui.treeView_functions, SIGNAL(clicked(const QModelIndex &)),
+            SLOT(onFuncViewClicked(const QModelIndex &)));
 
     m_ui.lineEdit_funcFilter->setPlaceholderText("Filter1;Filter2;...");
     connect(m_ui.lineEdit_funcFilter, SIGNAL(textChanged(const QString &)), SLOT(onFuncFilter_textChanged(const QString&)));
@@ -193,11 +230,17 @@ MainWindow::MainWindow(QWidget *parent)
     m_ui.widget_search->hide();
 
     
-    //Setup the class treewidget
-    treeWidget = m_ui.treeWidget_classes;
-    treeWidget->setColumnWidth(0, 200);
-    connect(m_ui.treeWidget_classes, SIGNAL(itemClicked(QTreeWidgetItem * , int )),
-            SLOT(onFuncWidgetItemSelected(QTreeWidgetItem * , int )));
+    //Setup the class treeview
+    m_ui.treeView_classes->setModel(&m_classListModel);
+    m_ui.treeView_classes->setColumnWidth(TagListModel::COLUMN_NAME, 200);
+    connect(m_ui.treeView_classes, SIGNAL(clicked(const QModelIndex &)),
+            SLOT(onClassViewClicked(const QModelIndex &)));
+    connect(&m_classListModel, SIGNAL(filterDone()), SLOT(expandClassList()));
+
+    // Setup the symbol search panel
+    m_symbolSearchWidget.setTagManager(&m_tagManager);
+    m_ui.tabWidget_tags->addTab(&m_symbolSearchWidget, "Symbols");
+    connect(&m_symbolSearchWidget, SIGNAL(symbolActivated(QString, int)), SLOT(onSymbolActivated(QString, int)));
 
 
 
@@ -243,6 +286,18 @@ MainWindow::MainWindow(QWidget *parent)
 MainWindow::~MainWindow()
 {
     loggerUnregister(this);
+
+    m_sourceFileChecker.requestQuit();
+    m_sourceFileChecker.wait();
+
+    // Write any breakpoint change that is still pending
+    if(m_breakpointSaveTimer.isActive())
+    {
+        m_breakpointSaveTimer.stop();
+        onBreakpointSaveTimeout();
+    }
+    m_breakpointSaver.requestQuit();
+    m_breakpointSaver.wait();
  
 }
 
@@ -253,9 +308,9 @@ MainWindow::~MainWindow()
 void MainWindow::showWidgets()
 {
     if(!m_cfg.m_viewFuncFilter)
-        m_funcFilterText.clear();
+        m_funcListModel.setFilterText("");
     if(!m_cfg.m_viewClassFilter)
-        m_classFilterText.clear();
+        m_classListModel.setFilterText("");
 
 
     m_ui.actionViewFunctionFilter->setChecked(m_cfg.m_viewFuncFilter);
@@ -266,17 +321,22 @@ void MainWindow::showWidgets()
     m_ui.tabWidget->clear();
 
 //
-    QTreeWidget *stackWidget = m_ui.treeWidget_stack;
+    QTreeView *stackWidget = m_ui.treeView_stack;
     if(m_cfg.m_viewWindowStack)
         m_ui.tabWidget->insertTab(0, stackWidget, "Stack");
 
+//
+    QTreeWidget *watchpointLogWidget = m_ui.treeWidget_watchpointLog;
+    if(m_cfg.m_viewWindowWatchpointLog)
+        m_ui.tabWidget->insertTab(0, watchpointLogWidget, "Watchpoint Log");
+
 //
     QTreeWidget *breakpointsWidget = m_ui.treeWidget_breakpoints;
     if(m_cfg.m_viewWindowBreakpoints)
         m_ui.tabWidget->insertTab(0, breakpointsWidget, "Breakpoints");
 
 //
-    QTreeWidget *threadsWidget = m_ui.treeWidget_threads;
+    QTreeView *threadsWidget = m_ui.treeView_threads;
     if(m_cfg.m_viewWindowThreads)
         m_ui.tabWidget->insertTab(0, threadsWidget, "Threads");
 
@@ -301,7 +361,7 @@ void MainWindow::showWidgets()
     
     m_ui.varWidget->setVisible(m_cfg.m_viewWindowWatch);
     m_ui.autoWidget->setVisible(m_cfg.m_viewWindowAutoVariables);
-    m_ui.treeWidget_file->setVisible(m_cfg.m_viewWindowFileBrowser);
+    m_ui.treeView_file->setVisible(m_cfg.m_viewWindowFileBrowser);
 
 
     currentSelection = m_ui.tabWidget_2->currentWidget();
@@ -317,7 +377,33 @@ void MainWindow::showWidgets()
         m_ui.tabWidget_2->setCurrentIndex(selectionIdx);
     m_ui.tabWidget_2->setVisible(m_ui.tabWidget_2->count() == 0 ? false : true);
 
+    updatePanelInterest();
+}
+
 
+/**
+ * @brief Tells core which panels that are shown and needs to be updated when the program stops.
+ */
+void MainWindow::updatePanelInterest()
+{
+    Core &core = Core::getInstance();
+    QWidget *currentWidget = m_ui.tabWidget->currentWidget();
+
+    core.setPanelVisible(Core::PANEL_STACK, m_cfg.m_viewWindowStack && currentWidget == m_ui.treeView_stack);
+    core.setPanelVisible(Core::PANEL_THREADS, m_cfg.m_viewWindowThreads && currentWidget == m_ui.treeView_threads);
+    core.setPanelVisible(Core::PANEL_WATCH, m_cfg.m_viewWindowWatch);
+    core.setPanelVisible(Core::PANEL_AUTO, m_cfg.m_viewWindowAutoVariables);
+}
+
+
+/**
+ * @brief Called when another tab (Eg: stack or threads) has been selected.
+ */
+void MainWindow::onPanelTabChanged(int index)
+{
+    Q_UNUSED(index);
+
+    updatePanelInterest();
 }
 
 
@@ -328,6 +414,7 @@ void MainWindow::onDefaultViewSetup()
 {
     m_cfg.m_viewWindowStack = true;
     m_cfg.m_viewWindowBreakpoints = true;
+    m_cfg.m_viewWindowWatchpointLog = true;
     m_cfg.m_viewWindowThreads = true;
     m_cfg.m_viewWindowWatch = true;
     m_cfg.m_viewWindowAutoVariables = true;
@@ -349,6 +436,7 @@ void MainWindow::onDefaultViewSetup()
     m_ui.actionViewStack->setChecked(m_cfg.m_viewWindowStack);
     m_ui.actionViewThreads->setChecked(m_cfg.m_viewWindowThreads);
     m_ui.actionViewBreakpoints->setChecked(m_cfg.m_viewWindowBreakpoints);
+    m_ui.actionViewWatchpointLog->setChecked(m_cfg.m_viewWindowWatchpointLog);
     m_ui.actionViewWatch->setChecked(m_cfg.m_viewWindowWatch);
     m_ui.actionViewAutoVariables->setChecked(m_cfg.m_viewWindowAutoVariables);
     m_ui.actionViewTargetOutput->setChecked(m_cfg.m_viewWindowTargetOutput);
@@ -396,6 +484,13 @@ void MainWindow::onViewBreakpoints()
     showWidgets();
 }
 
+void MainWindow::onViewWatchpointLog()
+{
+    m_cfg.m_viewWindowWatchpointLog = m_cfg.m_viewWindowWatchpointLog == true ? 0 : 1;
+
+    showWidgets();
+}
+
 void MainWindow::onViewThreads()
 {
     m_cfg.m_viewWindowThreads = m_cfg.m_viewWindowThreads == true ? 0 : 1;
@@ -466,6 +561,7 @@ void MainWindow::onViewFuncFilter()
 void MainWindow::loadConfig()
 {
     m_cfg.load();
+    m_savedBreakpoints = Settings::breakpointsToStringList(m_cfg.m_breakpoints);
 
 
     setConfig();
@@ -476,6 +572,7 @@ void MainWindow::loadConfig()
     m_ui.actionViewStack->setChecked(m_cfg.m_viewWindowStack);
     m_ui.actionViewThreads->setChecked(m_cfg.m_viewWindowThreads);
     m_ui.actionViewBreakpoints->setChecked(m_cfg.m_viewWindowBreakpoints);
+    m_ui.actionViewWatchpointLog->setChecked(m_cfg.m_viewWindowWatchpointLog);
     m_ui.actionViewWatch->setChecked(m_cfg.m_viewWindowWatch);
     m_ui.actionViewAutoVariables->setChecked(m_cfg.m_viewWindowAutoVariables);
     m_ui.actionViewTargetOutput->setChecked(m_cfg.m_viewWindowTargetOutput);
@@ -566,239 +663,93 @@ void MainWindow::ICore_onStopped(ICore::StopReason reason, QString path, int lin
     }
     
     updateCurrentLine(path, lineNo);
-    
-
-    fillInStack();
 }
 
 
 
 /**
- * @brief Finds a child to a treewidget node.
+ * @brief Fills in the source file treeview.
+ *
+ * The files are checked in a separate thread and the view is filled in
+ * when the check is done (see onSourceFilesChecked()).
  */
-QTreeWidgetItem *findTreeWidgetChildByName(QTreeWidget *treeWidget, QTreeWidgetItem *parent, QString name)
+void MainWindow::insertSourceFiles()
 {
-    QTreeWidgetItem *foundItem = NULL;
-    if(parent == NULL)
-        parent = treeWidget->invisibleRootItem();
+    Core &core = Core::getInstance();
 
-    for(int i = 0;i < parent->childCount() && foundItem == NULL;i++)
+    m_tagManager.abort();
+
+    // Get source files
+    QVector <SourceFile*> sourceFiles = core.getSourceFiles();
+    QStringList nameList;
+    QStringList fullNameList;
+    for(int i = 0;i < sourceFiles.size();i++)
     {
-        QTreeWidgetItem *childItem = parent->child(i);
-        if(childItem->text(0) == name)
-            foundItem = childItem;
+        SourceFile* source = sourceFiles[i];
+        nameList.append(source->m_name);
+        fullNameList.append(source->m_fullName);
     }
-    return foundItem;
+
+    m_sourceFileChecker.startJob(++m_sourceFileGeneration, nameList, fullNameList, m_cfg.m_sourceIgnoreDirs);
 }
 
-    
+
 /**
- * @brief Adds a path of directories to a tree widget.
- * @return returns the root directory of the newly created directories.
+ * @brief Called when the source files that exists and are not ignored are known.
+ * @param removedList   Files to remove (only for updates).
+ * @param isUpdate      True if the files should be added to the current files.
  */
-QTreeWidgetItem *MainWindow::addTreeWidgetPath(QTreeWidget *treeWidget, QTreeWidgetItem *parent, QString path)
+void MainWindow::onSourceFilesChecked(int generation, QStringList nameList, QStringList fullNameList,
+                                    QStringList removedList, bool isUpdate)
 {
-    QString firstName;
-    QString restPath;
-    QTreeWidgetItem *newItem = NULL;
-
-
-    // Divide the path into a folder and name part.
-    firstName = path;
-    int divPos = path.indexOf('/');
-    if(divPos != -1)
-    {
-        firstName = path.left(divPos);        
-        restPath = path.mid(divPos+1);
-    }
-
-    // Handle "../" paths
-    if(firstName == ".." && parent != NULL)
-    {
-        return addTreeWidgetPath(treeWidget, parent->parent(), restPath);
-    }
-    
-    // Empty name and only a path?
-    if(firstName.isEmpty())
-    {
-        if(restPath.isEmpty())
-            return NULL;
-        else
-            return addTreeWidgetPath(treeWidget, parent, restPath);
-    }
-        
-//    debugMsg("inserting: '%s', '%s'\n", stringToCStr(firstName), stringToCStr(restPath));
-
-
-    // Check if the item already exist?
-    newItem = findTreeWidgetChildByName(treeWidget, parent, firstName);
-
-    
-    
+    // Outdated result?
+    if(generation != m_sourceFileGeneration)
+        return;
 
-    // Add the item
-    if(newItem == NULL)
-    {
-        newItem = new QTreeWidgetItem;
-        newItem->setText(0, firstName); 
-        newItem->setIcon(0, m_folderIcon);
-    }
-    if(parent == NULL)
+    QModelIndexList expandList;
+    if(!isUpdate)
     {
-        treeWidget->insertTopLevelItem(0, newItem);
+        m_sourceFiles.clear();
+        m_fileTreeModel.setFiles(fullNameList);
+        expandList = m_fileTreeModel.getExpandedList();
     }
     else
     {
-        parent->addChild(newItem);
-        if(parent->text(0) != "usr" && parent->text(0) != "opt")
-            parent->setExpanded(true);
-    }
-
-    if(restPath.isEmpty())
-        return newItem;
-    else
-        return addTreeWidgetPath(treeWidget, newItem, restPath);
-}
-
-
-/**
- * @brief Try to shrink a tree by removing dirs in the tree. Eg: "/usr/include/bits" => "/usr...bits".
- */ 
-void MainWindow::wrapSourceTree(QTreeWidget *treeWidget)
-{
-    for(int u = 0;u < treeWidget->topLevelItemCount();u++)
-    {
-        QTreeWidgetItem* rootItem = treeWidget->topLevelItem (u);
-        QTreeWidgetItem* childItem = rootItem->child(0);
-        QString newName =  "/" + rootItem->text(0);
-        if(!childItem)
-            continue;
-        
-        do
+        // Remove the files
+        if(!removedList.isEmpty())
         {
-            if(childItem->childCount() > 0 && rootItem->childCount() == 1)
+            QSet<QString> removedSet;
+            for(int i = 0;i < removedList.size();i++)
             {
-                newName += "/" + childItem->text(0);
-                QList<QTreeWidgetItem *> subChildren = childItem->takeChildren();
-                childItem = rootItem->takeChild(0);
-                delete childItem;
-                rootItem->addChildren(subChildren);
-
-                childItem = subChildren.first();
+                removedSet.insert(removedList[i]);
+                m_tagManager.removeFile(removedList[i]);
             }
-        }
-        while(childItem->childCount() > 0 && rootItem->childCount() == 1);
-
-        if(rootItem->text(0) != "usr")
-            rootItem->setExpanded(true);
-
-        rootItem->setText(0, newName);
-
-    }
-}
-
-
-/**
- * @brief Fills in the source file treeview.
- */
-void MainWindow::insertSourceFiles()
-{
-    QTreeWidget *treeWidget = m_ui.treeWidget_file;
-    Core &core = Core::getInstance();
-
-    m_tagManager.abort();
-
-    treeWidget->clear();
-    
-    // Get source files
-    QVector <SourceFile*> sourceFiles = core.getSourceFiles();
-    m_sourceFiles.clear();
-    for(int i = 0;i < sourceFiles.size();i++)
-    {
-        SourceFile* source = sourceFiles[i];
-
-        // Ignore directory?
-        bool ignore = false;
-        for(int j = 0;j < m_cfg.m_sourceIgnoreDirs.size();j++)
-        {
-            QString ignoreDir = m_cfg.m_sourceIgnoreDirs[j];
-            if(!ignoreDir.isEmpty())
+            for(int i = m_sourceFiles.size()-1;i >= 0;i--)
             {
-                if(source->m_fullName.startsWith(ignoreDir))
-                    ignore = true;
+                if(removedSet.contains(m_sourceFiles[i].m_fullName))
+                    m_sourceFiles.removeAt(i);
             }
+            m_fileTreeModel.removeFiles(removedList, &expandList);
         }
 
-        if(!ignore)
-        {
-            
-            // File exist?
-            if(!QFileInfo(source->m_fullName).exists())
-            {
-                debugMsg("File '%s' does not exist", qPrintable(source->m_fullName));
-            }
-            else    
-            {
-                FileInfo info;
-                info.m_name = source->m_name;
-                info.m_fullName = source->m_fullName;
-                
-                m_sourceFiles.push_back(info);
-            }
-        }
+        m_fileTreeModel.addFiles(fullNameList, &expandList);
     }
 
-    
-
-    // Queue all scans
-    QStringList queueList;
-    for(int i = 0;i < m_sourceFiles.size();i++)
+    for(int i = 0;i < fullNameList.size();i++)
     {
-        FileInfo &info = m_sourceFiles[i];
-        queueList += info.m_fullName;
+        FileInfo info;
+        info.m_name = nameList[i];
+        info.m_fullName = fullNameList[i];
+        m_sourceFiles.push_back(info);
     }
-    m_tagManager.queueScan(queueList);
 
-    
-    for(int i = 0;i < m_sourceFiles.size();i++)
-    {
-        const FileInfo &info = m_sourceFiles[i];
-        QTreeWidgetItem *parentNode  = NULL;
-
-        // Get parent path
-        QString folderPath;
-        QString filename;
-        dividePath(info.m_fullName, &filename, &folderPath);
-        folderPath = simplifyPath(folderPath);
-        
-        if(!folderPath.isEmpty())
-            parentNode = addTreeWidgetPath(treeWidget, NULL, folderPath);
-            
+    m_locator.onSourceFilesChanged();
 
-        // Check if the item already exist?
-        QTreeWidgetItem *item = findTreeWidgetChildByName(treeWidget, parentNode, filename);
-        
-        if(item == NULL)
-        {
-            item = new QTreeWidgetItem;
-            item->setText(0, filename);
-            item->setData(0, Qt::UserRole, info.m_fullName);
-            item->setIcon(0, m_fileIcon);
-            
-            if(parentNode == NULL)
-                treeWidget->insertTopLevelItem(0, item);
-            else
-            {
-                parentNode->addChild(item);
-                parentNode->setExpanded(true);
-            }
-        }
-    }
-
-    wrapSourceTree(treeWidget);
-
-    treeWidget->sortItems(0, Qt::AscendingOrder);
+    // Queue the scans (the function and class lists are updated when done)
+    m_tagManager.queueScan(fullNameList);
 
+    for(int i = 0;i < expandList.size();i++)
+        m_ui.treeView_file->expand(expandList[i]);
 }
 
 
@@ -838,7 +789,7 @@ void MainWindow::ICore_onSourceFileChanged(QString filename)
     {
         // Get the tags in the file
         QList<Tag> tagList;
-        m_tagManager.scan(filename, &tagList);
+        m_tagManager.rescan(filename, &tagList);
 
         // Open the file
         if(codeViewTab->open(filename,tagList))
@@ -853,6 +804,29 @@ void MainWindow::ICore_onSourceFileListChanged()
     insertSourceFiles();
 }
 
+
+/**
+ * @brief Called when files has been added or removed in the list of source files.
+ */
+void MainWindow::ICore_onSourceFilesUpdated(QStringList addedList, QStringList removedList)
+{
+    Core &core = Core::getInstance();
+
+    QStringList nameList;
+    QStringList fullNameList;
+    for(int i = 0;i < addedList.size();i++)
+    {
+        SourceFile *source = core.findSourceFile(addedList[i]);
+        if(source)
+        {
+            nameList.append(source->m_name);
+            fullNameList.append(source->m_fullName);
+        }
+    }
+
+    m_sourceFileChecker.queueUpdate(m_sourceFileGeneration, nameList, fullNameList, removedList, m_cfg.m_sourceIgnoreDirs);
+}
+
 /**
  * @brief User doubleclicked on the border
  * @param lineNo    The line pressed (1=first row).
@@ -947,67 +921,83 @@ void MainWindow::ICore_onMessage(QString message)
 }
     
 
-void MainWindow::fillInStack()
-{
-    Core &core = Core::getInstance();
-    
-    core.getStackFrames();
-
-}
-
-
 void
 MainWindow::onThreadWidgetSelectionChanged( )
 {
     // Get the new selected thread
-    QTreeWidget *threadWidget = m_ui.treeWidget_threads;
-    QList <QTreeWidgetItem *> selectedItems = threadWidget->selectedItems();
-    if(selectedItems.size() > 0)
+    QModelIndexList selectedRows = m_ui.treeView_threads->selectionModel()->selectedRows();
+    if(selectedRows.size() > 0)
     {
-        QTreeWidgetItem * currentItem;
-        currentItem = selectedItems[0];
-        int selectedThreadId = currentItem->data(0, Qt::UserRole).toInt();
+        int selectedThreadId = m_threadListModel.getThreadId(selectedRows[0]);
 
         // Select the thread
         Core &core = Core::getInstance();
-        core.selectThread(selectedThreadId);
+        if(selectedThreadId != -1)
+            core.selectThread(selectedThreadId);
     }
 }
 
+/**
+ * @brief Called when threads has been expanded in the thread view.
+ */
+void MainWindow::onThreadFramesRequested(QList<int> threadIdList)
+{
+    Core &core = Core::getInstance();
+
+    QHash<int, QList<StackFrameEntry> > frameMap = core.getThreadFrames(threadIdList);
+    for(int i = 0;i < threadIdList.size();i++)
+        m_threadListModel.setFrames(threadIdList[i], frameMap.value(threadIdList[i]));
+}
+
+
+/**
+ * @brief Opens the location of a stack frame in the thread view.
+ */
+void MainWindow::onThreadViewDoubleClicked(const QModelIndex &index)
+{
+    QString filePath;
+    int lineNo;
+    if(m_threadListModel.getFrameLocation(index, &filePath, &lineNo))
+        open(filePath, lineNo);
+}
+
+
 void MainWindow::onStackWidgetSelectionChanged()
 {
     Core &core = Core::getInstance();
         
-    int selectedFrame = -1;
     // Get the new selected frame
-    QTreeWidget *stackWidget = m_ui.treeWidget_stack;
-    QList <QTreeWidgetItem *> selectedItems = stackWidget->selectedItems();
-    if(selectedItems.size() > 0)
+    QModelIndexList selectedRows = m_ui.treeView_stack->selectionModel()->selectedRows();
+    if(selectedRows.size() > 0)
     {
-        QTreeWidgetItem * currentItem;
-        currentItem = selectedItems[0];
-        selectedFrame = currentItem->data(0, Qt::UserRole).toInt();
-
-        core.selectFrame(selectedFrame);
+        int selectedFrame = m_stackFrameModel.getFrameIdx(selectedRows[0]);
+        if(selectedFrame != -1)
+            core.selectFrame(selectedFrame);
     }
 }
 
 
+/**
+ * @brief Called when frames are shown in the stack view that has not been fetched.
+ */
+void MainWindow::onStackFramesRequested(int lowFrame, int highFrame)
+{
+    Core &core = Core::getInstance();
+
+    m_stackFrameModel.setFrames(lowFrame, core.getStackFrames(lowFrame, highFrame));
+}
 
 
 
 
 
-void MainWindow::onFolderViewItemActivated ( QTreeWidgetItem * item, int column )
-{
-    Q_UNUSED(column);
 
-    if(item->childCount() == 0)
-    {
-        QString filename  = item->data(0, Qt::UserRole).toString();
 
+void MainWindow::onFolderViewItemActivated(const QModelIndex &index)
+{
+    QString filename = m_fileTreeModel.getFilePath(index);
+    if(!filename.isEmpty())
         open(filename);
-    }
 }
 
 CodeViewTab* MainWindow::currentTab()
@@ -1234,7 +1224,8 @@ CodeViewTab* MainWindow::open(QString filename)
 
     m_locator.setCurrentFile(filename);
 
-    ICore_onBreakpointsChanged();
+    Core &core = Core::getInstance();
+    codeViewTab->setBreakpoints(core.getBreakpointLines(filename));
 
     return codeViewTab;
 }
@@ -1403,6 +1394,69 @@ void MainWindow::onContinue()
 }
 
 
+/**
+ * @brief Called when user presses "Execution->Next N times".
+ */
+void MainWindow::onNextMany()
+{
+    bool ok = false;
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+    int count = QInputDialog::getInt(this, "Next N times",
+                            "Number of rows to step:", 10, 1, INT_MAX, 1, &ok);
+#else
+    int count = QInputDialog::getInteger(this, "Next N times",
+                            "Number of rows to step:", 10, 1, INT_MAX, 1, &ok);
+#endif
+    if(!ok)
+        return;
+
+    Core &core = Core::getInstance();
+    if(core.gdbNextMany(count) == 0)
+        onCurrentLineDisabled();
+}
+
+
+/**
+ * @brief Called when user presses "Execution->Next until expression is true".
+ */
+void MainWindow::onNextUntil()
+{
+    bool ok = false;
+    QString expr = QInputDialog::getText(this, "Next until expression is true",
+                            "Expression (Eg: i == 10):", QLineEdit::Normal,
+                            m_nextUntilExpression, &ok);
+    if(!ok || expr.trimmed().isEmpty())
+        return;
+    m_nextUntilExpression = expr;
+
+    Core &core = Core::getInstance();
+    if(core.gdbNextUntil(expr) == 0)
+        onCurrentLineDisabled();
+}
+
+
+/**
+ * @brief Called when user presses "Execution->Continue N breakpoint hits".
+ */
+void MainWindow::onContinueHits()
+{
+    bool ok = false;
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+    int count = QInputDialog::getInt(this, "Continue N breakpoint hits",
+                            "Number of breakpoint hits:", 10, 1, INT_MAX, 1, &ok);
+#else
+    int count = QInputDialog::getInteger(this, "Continue N breakpoint hits",
+                            "Number of breakpoint hits:", 10, 1, INT_MAX, 1, &ok);
+#endif
+    if(!ok)
+        return;
+
+    Core &core = Core::getInstance();
+    if(core.gdbContinueHits(count) == 0)
+        onCurrentLineDisabled();
+}
+
+
 void MainWindow::onStepIn()
 {
     Core &core = Core::getInstance();
@@ -1418,156 +1472,218 @@ void MainWindow::onStepOut()
 }
 
 
-void MainWindow::ICore_onThreadListChanged()
+void MainWindow::ICore_onThreadAdded(ThreadInfo info)
 {
-    Core &core = Core::getInstance();
+    m_threadListModel.addThread(info);
+}
 
-    QTreeWidget *threadWidget = m_ui.treeWidget_threads;
-    threadWidget->clear();
 
-    QList<ThreadInfo> list = core.getThreadList();
-    
-    for(int idx = 0;idx < list.size();idx++)
-    {
-        // Get name
-        QString name = list[idx].m_name;
-        QString desc = list[idx].m_details;
-        
+void MainWindow::ICore_onThreadChanged(ThreadInfo info)
+{
+    m_threadListModel.updateThread(info);
+}
 
-        // Add the item
-        QStringList names;
-        names.push_back(name);
-        names.push_back(desc);
-        QTreeWidgetItem *item = new QTreeWidgetItem(names);
-        item->setData(0, Qt::UserRole, list[idx].m_id);
-        item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
-        threadWidget->insertTopLevelItem(0, item);
 
-    }
+void MainWindow::ICore_onThreadRemoved(int threadId)
+{
+    m_threadListModel.removeThread(threadId);
 }
 
 
 void MainWindow::ICore_onCurrentThreadChanged(int threadId)
 {
-    QTreeWidget *threadWidget = m_ui.treeWidget_threads;
-    QTreeWidgetItem *rootItem = threadWidget->invisibleRootItem();
-    threadWidget->clearSelection();
-    QTreeWidgetItem *selectItem = NULL;
-    for(int i = 0;i < rootItem->childCount();i++)
+    QTreeView *threadView = m_ui.treeView_threads;
+    QModelIndex index = m_threadListModel.findThread(threadId);
+    threadView->clearSelection();
+    if(index.isValid())
     {
-        QTreeWidgetItem *item = rootItem->child(i);
-        assert(item != NULL);
-        if(item)
-        {
-            int id = item->data(0, Qt::UserRole).toInt();
-            if(id == threadId)
-            {
-                selectItem = item;
-            }
-        }
+        threadView->setCurrentIndex(index);
+        threadView->scrollTo(index);
     }
-    if(selectItem)
-        threadWidget->setCurrentItem(selectItem);
 }
 
 
 
 
-void MainWindow::ICore_onBreakpointsChanged()
+/**
+ * @brief Writes the breakpoints to the project config file (in the background).
+ */
+void MainWindow::onBreakpointSaveTimeout()
 {
     Core &core = Core::getInstance();
     QList<BreakPoint*>  bklist = core.getBreakPoints();
-    
 
     // Update the settings
     m_cfg.m_breakpoints.clear();
     for(int u = 0;u < bklist.size();u++)
     {
         BreakPoint* bkpt = bklist[u];
+
+        // Log points would be restored as ordinary breakpoints
+        if(bkpt->m_isLogPoint || bkpt->isWatchPoint())
+            continue;
+
         SettingsBreakpoint bkptCfg;
         bkptCfg.m_filename = bkpt->m_fullname;
         bkptCfg.m_lineNo = bkpt->m_lineNo;
         m_cfg.m_breakpoints.push_back(bkptCfg);
     }
-    m_cfg.save();
-    
 
-    // Update the breakpoint list widget
-    m_ui.treeWidget_breakpoints->clear();
-    for(int i = 0;i <  bklist.size();i++)
-    {
-        BreakPoint* bk = bklist[i];
-
-        QStringList nameList;
-        QString name;
-        nameList.append(getFilenamePart(bk->m_fullname));
-        name = QString::asprintf("%d", bk->m_lineNo);
-        nameList.append(name);
-        nameList.append(bk->m_funcName);
-        nameList.append(longLongToHexString(bk->m_addr));
-        
-        
-
-        QTreeWidgetItem *item = new QTreeWidgetItem(nameList);
-        item->setData(0, Qt::UserRole, i);
-        item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+    QStringList breakpointStringList = Settings::breakpointsToStringList(m_cfg.m_breakpoints);
+    if(breakpointStringList == m_savedBreakpoints)
+        return;
+    m_savedBreakpoints = breakpointStringList;
 
-        // Add the item to the widget
-        m_ui.treeWidget_breakpoints->insertTopLevelItem(0, item);
+    m_breakpointSaver.queueSave(m_cfg.getProjectConfigPath(), breakpointStringList);
+}
 
-    }
 
-    // Update the fileview
+/**
+ * @brief Updates the breakpoint markers in the tabs showing a file.
+ */
+void MainWindow::updateBreakpointMarkers(QString fullPath)
+{
+    Core &core = Core::getInstance();
     for(int tabIdx = 0;tabIdx <  m_ui.editorTabWidget->count();tabIdx++)
     {
         CodeViewTab* codeViewTab = (CodeViewTab* )m_ui.editorTabWidget->widget(tabIdx);
+        if(codeViewTab->getFilePath() == fullPath)
+            codeViewTab->setBreakpoints(core.getBreakpointLines(fullPath));
+    }
+}
 
-        QVector<int> numList;
-        for(int i = 0;i <  bklist.size();i++)
-        {
-            BreakPoint* bk = bklist[i];
-
-            if(bk->m_fullname == codeViewTab->getFilePath())
-                numList.push_back(bk->m_lineNo);
-        }
 
-        codeViewTab->setBreakpoints(numList);
+/**
+ * @brief Fills in the columns of a item in the breakpoint list widget.
+ */
+void MainWindow::setBreakpointItem(QTreeWidgetItem *item, BreakPoint *bkpt)
+{
+    if(bkpt->isWatchPoint())
+    {
+        QString title;
+        if(bkpt->m_watchType == BreakPoint::WATCH_READ)
+            title = "Read watch: ";
+        else if(bkpt->m_watchType == BreakPoint::WATCH_ACCESS)
+            title = "Access watch: ";
+        else
+            title = "Watch: ";
+        item->setText(BKPT_COLUMN_FILENAME, title + bkpt->m_watchExpression);
+        item->setText(BKPT_COLUMN_LINE, "");
     }
+    else
+    {
+        item->setText(BKPT_COLUMN_FILENAME, getFilenamePart(bkpt->m_fullname));
+        item->setText(BKPT_COLUMN_LINE, QString::asprintf("%d", bkpt->m_lineNo));
+    }
+    item->setText(BKPT_COLUMN_FUNC, bkpt->m_funcName);
+    item->setText(BKPT_COLUMN_ADDR, longLongToHexString(bkpt->m_addr));
+    QString hits = QString::asprintf("%d", bkpt->m_hitCount);
+    if(bkpt->m_ignoreCount > 0)
+        hits += QString::asprintf(" (ignore %d)", bkpt->m_ignoreCount);
+    item->setText(BKPT_COLUMN_HITS, hits);
+    if(bkpt->m_isLogPoint)
+        item->setText(BKPT_COLUMN_CONDITION, "Log point");
+    else if(bkpt->m_autoContinue)
+        item->setText(BKPT_COLUMN_CONDITION, "Log only");
+    else
+        item->setText(BKPT_COLUMN_CONDITION, bkpt->m_condition);
+    item->setText(BKPT_COLUMN_ENABLED, bkpt->m_enabled ? "Yes" : "No");
+    item->setData(0, Qt::UserRole, bkpt->m_number);
+    item->setData(0, Qt::UserRole+1, bkpt->m_fullname);
+    item->setData(0, Qt::UserRole+2, bkpt->m_lineNo);
 }
 
 
-
-void MainWindow::ICore_onStackFrameChange(QList<StackFrameEntry> stackFrameList)
+void MainWindow::ICore_onBreakpointAdded(BreakPoint *bkpt)
 {
-    m_stackFrameList = stackFrameList;
-    QTreeWidget *stackWidget = m_ui.treeWidget_stack;
-    
-    stackWidget->clear();
+    QTreeWidgetItem *item = new QTreeWidgetItem();
+    item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+    setBreakpointItem(item, bkpt);
+    m_ui.treeWidget_breakpoints->insertTopLevelItem(0, item);
+    m_breakpointItems[bkpt->m_number] = item;
 
+    updateBreakpointMarkers(bkpt->m_fullname);
 
-    
-    for(int idx = 0;idx < stackFrameList.size();idx++)
+    // Save them later to avoid writing the file for each breakpoint in a burst of changes
+    m_breakpointSaveTimer.start();
+}
+
+
+void MainWindow::ICore_onBreakpointModified(BreakPoint *bkpt)
+{
+    QTreeWidgetItem *item = m_breakpointItems.value(bkpt->m_number, NULL);
+    if(item == NULL)
     {
-        // Get name
-        StackFrameEntry &entry = stackFrameList[stackFrameList.size()-idx-1];
-        
+        ICore_onBreakpointAdded(bkpt);
+        return;
+    }
 
-        // Create the item
-        QStringList names;
-        names.push_back(entry.m_functionName);
-        
-        QTreeWidgetItem *item = new QTreeWidgetItem(names);
+    QString oldPath = item->data(0, Qt::UserRole+1).toString();
+    int oldLineNo = item->data(0, Qt::UserRole+2).toInt();
+    setBreakpointItem(item, bkpt);
 
-        
-        item->setData(0, Qt::UserRole, idx);
-        item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+    // Only the hit count, condition or enabled state changed?
+    if(oldPath == bkpt->m_fullname && oldLineNo == bkpt->m_lineNo)
+        return;
 
-        // Add the item to the widget
-        stackWidget->insertTopLevelItem(0, item);
+    updateBreakpointMarkers(oldPath);
+    if(oldPath != bkpt->m_fullname)
+        updateBreakpointMarkers(bkpt->m_fullname);
 
+    m_breakpointSaveTimer.start();
+}
 
-    }
-    
+
+/**
+ * @brief Adds a watchpoint trigger to the watchpoint log.
+ */
+void MainWindow::ICore_onWatchPointTriggered(WatchPointHit hit)
+{
+    QTreeWidget *logWidget = m_ui.treeWidget_watchpointLog;
+
+    QStringList columns;
+    columns.append(QString::asprintf("#%d ", hit.m_number) + hit.m_expression);
+    columns.append(hit.m_oldValue);
+    columns.append(hit.m_newValue);
+    columns.append(longLongToHexString(hit.m_pc));
+    columns.append(QString::asprintf("%d", hit.m_threadId));
+    QString location = hit.m_funcName;
+    if(!hit.m_fullname.isEmpty())
+        location += QString::asprintf(" (%s:%d)", stringToCStr(getFilenamePart(hit.m_fullname)), hit.m_lineNo);
+    columns.append(location);
+
+    QTreeWidgetItem *item = new QTreeWidgetItem(columns);
+    item->setFlags(Qt::ItemIsEnabled | Qt::ItemIsSelectable);
+    logWidget->insertTopLevelItem(0, item);
+
+    // Remove the oldest entries
+    while(logWidget->topLevelItemCount() > WATCHPOINT_LOG_SIZE)
+        delete logWidget->takeTopLevelItem(logWidget->topLevelItemCount()-1);
+}
+
+
+void MainWindow::ICore_onBreakpointDeleted(int number)
+{
+    QTreeWidgetItem *item = m_breakpointItems.take(number);
+    if(item == NULL)
+        return;
+    QString oldPath = item->data(0, Qt::UserRole+1).toString();
+    delete item;
+
+    updateBreakpointMarkers(oldPath);
+
+    m_breakpointSaveTimer.start();
+}
+
+
+/**
+ * @brief The number of frames in the stack has changed.
+ *
+ * The frames are fetched by the model when they are shown.
+ */
+void MainWindow::ICore_onStackDepthChanged(int depth)
+{
+    m_stackFrameModel.setDepth(depth);
 }
 
 
@@ -1578,33 +1694,22 @@ void MainWindow::ICore_onStackFrameChange(QList<StackFrameEntry> stackFrameList)
 */
 void MainWindow::ICore_onCurrentFrameChanged(int frameIdx)
 {
-    QTreeWidget *stackWidget = m_ui.treeWidget_stack;
+    QTreeView *stackView = m_ui.treeView_stack;
 
     // Update the sourceview (with the current row).
-    if(frameIdx >= 0 && frameIdx < m_stackFrameList.size())
-    {
-        StackFrameEntry &entry = m_stackFrameList[m_stackFrameList.size()-frameIdx-1];
+    // (A frame that has not been fetched yet has already been shown by ICore_onStopped())
+    StackFrameEntry entry;
+    if(m_stackFrameModel.getFrame(frameIdx, &entry))
+        updateCurrentLine(entry.m_sourcePath, entry.m_line);
 
-        QString currentFile = entry.m_sourcePath;
-        updateCurrentLine(currentFile, entry.m_line);
-    }
-
-    // Update the selection of the current thread
-    QTreeWidgetItem *rootItem = stackWidget->invisibleRootItem();
-    stackWidget->clearSelection();
-    QTreeWidgetItem *selectItem = NULL;
-    for(int i = 0;i < rootItem->childCount();i++)
+    // Update the selection of the current frame
+    QModelIndex index = m_stackFrameModel.findFrame(frameIdx);
+    stackView->clearSelection();
+    if(index.isValid())
     {
-        QTreeWidgetItem *item = rootItem->child(i);
-        int id = item->data(0, Qt::UserRole).toInt();
-        if(id == frameIdx)
-        {
-            selectItem = item;
-        }
+        stackView->setCurrentIndex(index);
+        stackView->scrollTo(index);
     }
-    if(selectItem)
-        stackWidget->setCurrentItem(selectItem);
-    
 }
 
 void MainWindow::ICore_onFrameVarReset()
@@ -1624,9 +1729,10 @@ void MainWindow::onBreakpointsWidgetItemDoubleClicked(QTreeWidgetItem * item,int
     Q_UNUSED(column);
 
     Core &core = Core::getInstance();
-    QList<BreakPoint*>  bklist = core.getBreakPoints();
-    int idx = item->data(0, Qt::UserRole).toInt();
-    BreakPoint* bk = bklist[idx];
+    int number = item->data(0, Qt::UserRole).toInt();
+    BreakPoint* bk = core.findBreakPointByNumber(number);
+    if(bk == NULL || bk->isWatchPoint())
+        return;
 
     CodeViewTab* currentCodeViewTab = open(bk->m_fullname);
     if(currentCodeViewTab)
@@ -1691,45 +1797,34 @@ void MainWindow::ICodeView_onContextMenu(QPoint pos, int lineNo, QStringList tex
             wantedTag = wantedTag.mid(wantedTag.lastIndexOf('.')+1);
 
         
-        // Loop through all the source files
-        for(int i = 0;i < m_sourceFiles.size();i++)
-        {
-            FileInfo& fileInfo = m_sourceFiles[i];
+        // Find all tags with the name
+        QList<Tag> tagList;
+        m_tagManager.lookupName(wantedTag, &tagList);
 
-            QList<Tag> tagList;
-            m_tagManager.getTags(fileInfo.m_fullName, &tagList);
+        // Loop through all the tags
+        for(int j = 0;j < tagList.size();j++)
+        {
+            Tag &tagInfo = tagList[j];
 
-            // Loop through all the tags
-            for(int j = 0;j < tagList.size();j++)
+            if(totalItemCount++ < 20)
             {
-                Tag &tagInfo = tagList[j];
-                QString tagName = tagInfo.m_name;
-
-                // Tag match?
-                if(tagName == wantedTag)
-                {
-
-                    if(totalItemCount++ < 20)
-                    {
-                        // Get filename and lineNo
-                        QStringList defList;
-                        defList.push_back(fileInfo.m_fullName);
-                        QString lineNoStr;
-                        lineNoStr = QString::asprintf("%d", tagInfo.getLineNo());
-                        defList.push_back(lineNoStr);
-
-                        if(!tagInfo.isFunc())
-                            onlyFuncs = false;
-                            
-                        // Add to popupmenu
-                        QString menuEntryText;
-                        menuEntryText = QString::asprintf("Show definition of '%s' L%d", stringToCStr(tagInfo.getLongName()), tagInfo.getLineNo());
-                        menuEntryText.replace("&", "&&");
-                        QAction *action = new QAction(menuEntryText, &m_popupMenu);
-                        action->setData(defList);
-                        defActionList.push_back(action);
-                    }
-                }
+                // Get filename and lineNo
+                QStringList defList;
+                defList.push_back(tagInfo.getFilePath());
+                QString lineNoStr;
+                lineNoStr = QString::asprintf("%d", tagInfo.getLineNo());
+                defList.push_back(lineNoStr);
+
+                if(!tagInfo.isFunc())
+                    onlyFuncs = false;
+                    
+                // Add to popupmenu
+                QString menuEntryText;
+                menuEntryText = QString::asprintf("Show definition of '%s' L%d", stringToCStr(tagInfo.getLongName()), tagInfo.getLineNo());
+                menuEntryText.replace("&", "&&");
+                QAction *action = new QAction(menuEntryText, &m_popupMenu);
+                action->setData(defList);
+                defActionList.push_back(action);
             }
         }
     }
@@ -1758,6 +1853,28 @@ void MainWindow::ICodeView_onContextMenu(QPoint pos, int lineNo, QStringList tex
     action->setData(lineNo);
     connect(action, SIGNAL(triggered()), this, SLOT(onCodeViewContextMenuToggleBreakpoint()));
 
+    // Add 'Set condition' and 'Set ignore count' if there is a breakpoint on the line
+    CodeViewTab* currentCodeViewTab = currentTab();
+    BreakPoint* bkpt = NULL;
+    if(currentCodeViewTab)
+        bkpt = Core::getInstance().findBreakPoint(currentCodeViewTab->getFilePath(), lineNo);
+    if(bkpt)
+    {
+        action = m_popupMenu.addAction("Set breakpoint condition...");
+        action->setData(bkpt->m_number);
+        connect(action, SIGNAL(triggered()), this, SLOT(onBreakpointSetCondition()));
+
+        action = m_popupMenu.addAction("Set breakpoint ignore count...");
+        action->setData(bkpt->m_number);
+        connect(action, SIGNAL(triggered()), this, SLOT(onBreakpointSetIgnoreCount()));
+    }
+
+    // Add 'Add log point'
+    title = QString::asprintf("Add log point at L%d...", lineNo);
+    action = m_popupMenu.addAction(title);
+    action->setData(lineNo);
+    connect(action, SIGNAL(triggered()), this, SLOT(onCodeViewContextMenuAddLogPoint()));
+
     action = m_popupMenu.addSeparator();
 
     // Add to the menu
@@ -1823,6 +1940,95 @@ void MainWindow::onCodeViewContextMenuToggleBreakpoint()
 }
 
 
+/**
+ * @brief Asks for a message and adds a log point that prints it without stopping the program.
+ */
+void MainWindow::onCodeViewContextMenuAddLogPoint()
+{
+    QAction *action = static_cast<QAction *>(sender ());
+    int lineNo = action->data().toInt();
+    Core &core = Core::getInstance();
+
+    CodeViewTab* currentCodeViewTab = currentTab();
+    if(!currentCodeViewTab)
+        return;
+
+    bool ok = false;
+    QString format = QInputDialog::getText(this, "Add log point",
+                            "Message to print (printf format, Eg: 'x=%d'):",
+                            QLineEdit::Normal, "", &ok);
+    if(!ok || format.isEmpty())
+        return;
+    QString args = QInputDialog::getText(this, "Add log point",
+                            "Expressions to print (separated with ','):",
+                            QLineEdit::Normal, "", &ok);
+    if(!ok)
+        return;
+
+    QStringList argList;
+    if(!args.trimmed().isEmpty())
+        argList = splitExpressionList(args);
+    core.gdbSetLogPoint(currentCodeViewTab->getFilePath(), lineNo, format, argList);
+}
+
+
+/**
+ * @brief Asks for a new condition for a breakpoint.
+ */
+void MainWindow::onBreakpointSetCondition()
+{
+    QAction *action = static_cast<QAction *>(sender ());
+    int number = action->data().toInt();
+    Core &core = Core::getInstance();
+
+    BreakPoint* bkpt = core.findBreakPointByNumber(number);
+    if(bkpt == NULL)
+        return;
+
+    bool ok = false;
+    QString condition = QInputDialog::getText(this, "Breakpoint condition",
+                            "Stop only if this expression is true (empty for always):",
+                            QLineEdit::Normal, bkpt->m_condition, &ok);
+    if(!ok)
+        return;
+
+    // The breakpoint may have been removed while the dialog was shown
+    bkpt = core.findBreakPointByNumber(number);
+    if(bkpt)
+        core.gdbSetBreakpointCondition(bkpt, condition);
+}
+
+
+/**
+ * @brief Asks for the number of hits that a breakpoint should ignore.
+ */
+void MainWindow::onBreakpointSetIgnoreCount()
+{
+    QAction *action = static_cast<QAction *>(sender ());
+    int number = action->data().toInt();
+    Core &core = Core::getInstance();
+
+    BreakPoint* bkpt = core.findBreakPointByNumber(number);
+    if(bkpt == NULL)
+        return;
+
+    bool ok = false;
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+    int count = QInputDialog::getInt(this, "Breakpoint ignore count",
+                            "Number of hits to ignore:", bkpt->m_ignoreCount, 0, INT_MAX, 1, &ok);
+#else
+    int count = QInputDialog::getInteger(this, "Breakpoint ignore count",
+                            "Number of hits to ignore:", bkpt->m_ignoreCount, 0, INT_MAX, 1, &ok);
+#endif
+    if(!ok)
+        return;
+
+    bkpt = core.findBreakPointByNumber(number);
+    if(bkpt)
+        core.gdbSetBreakpointIgnoreCount(bkpt, count);
+}
+
+
 void MainWindow::onCodeViewContextMenuShowCurrentLocation()
 {
     // Open file
@@ -2003,8 +2209,6 @@ void MainWindow::ICore_onSignalReceived(QString signalName)
     }
     
     onCurrentLineDisabled();
-        
-    fillInStack();
 
 }
 
@@ -2029,6 +2233,9 @@ void MainWindow::ICore_onStateChanged(TargetState state)
     m_ui.actionStep_Out->setEnabled(isStopped);
     m_ui.actionStop->setEnabled(isRunning);
     m_ui.actionContinue->setEnabled(isStopped);
+    m_ui.actionNextMany->setEnabled(isStopped);
+    m_ui.actionNextUntil->setEnabled(isStopped);
+    m_ui.actionContinueHits->setEnabled(isStopped);
     m_ui.actionRestart->setEnabled(!isRunning);
 
     m_ui.varWidget->setEnabled(!isRunning);
@@ -2036,12 +2243,53 @@ void MainWindow::ICore_onStateChanged(TargetState state)
     
     if(state == TARGET_STARTING || state == TARGET_RUNNING)
     {
-        m_ui.treeWidget_stack->clear();
+        m_stackFrameModel.clear();
+
+        // The frames of the threads are only valid until the program resumes
+        m_ui.treeView_threads->collapseAll();
+        m_threadListModel.clearFrames();
     }
     m_autoVarCtl.ICore_onStateChanged(state);
 }
 
 
+/**
+ * @brief Disables the parts of the gui that sends commands to gdb while gdb loads the symbols.
+ *
+ * A command sent while gdb loads the symbols would block the gui until
+ * the loading is done.
+ */
+void MainWindow::setSymbolsLoading(bool loading)
+{
+    if(loading)
+    {
+        QList<QAction*> actionList;
+        actionList += m_ui.menuSearch->actions();
+        actionList += m_ui.menuExecution->actions();
+        actionList += m_ui.menuView->actions();
+        actionList.append(m_ui.actionSettings);
+        for(int i = 0;i < actionList.size();i++)
+        {
+            QAction *action = actionList[i];
+            if(action->isEnabled() && !action->isSeparator())
+            {
+                action->setEnabled(false);
+                m_loadingDisabledActions.append(action);
+            }
+        }
+        statusBar()->showMessage("Loading symbols...");
+    }
+    else
+    {
+        for(int i = 0;i < m_loadingDisabledActions.size();i++)
+            m_loadingDisabledActions[i]->setEnabled(true);
+        m_loadingDisabledActions.clear();
+        statusBar()->clearMessage();
+    }
+    m_ui.centralwidget->setEnabled(!loading);
+}
+
+
 /**
 * @brief Sets the status line in the mainwindow
 */
@@ -2093,20 +2341,16 @@ void MainWindow::onBreakpointsRemoveSelected()
 
     // Get a list of breakpoints
     Core &core = Core::getInstance();
-    QList<BreakPoint*>  bklist = core.getBreakPoints();
-    QList <int>idList;
     QList<BreakPoint*>  toRemove;
     for(int u = 0;u < selectedItems.size();u++)
     {
         // Get the breakpoint
         QTreeWidgetItem *item = selectedItems[u];
         assert(item != NULL);
-        int idx = item->data(0, Qt::UserRole).toInt();
-        if(0 <= idx && idx < bklist.size())
-        {
-            BreakPoint* bkpt = bklist[idx];
+        int number = item->data(0, Qt::UserRole).toInt();
+        BreakPoint* bkpt = core.findBreakPointByNumber(number);
+        if(bkpt)
             toRemove.append(bkpt);
-        }
     }
 
 
@@ -2128,18 +2372,15 @@ void MainWindow::onBreakpointsGoTo()
     QTreeWidget *bkptWidget = m_ui.treeWidget_breakpoints;
     QList<QTreeWidgetItem *> selectedItems = bkptWidget->selectedItems();
 
-    // Get a list of breakpoints
     Core &core = Core::getInstance();
-    QList<BreakPoint*>  bklist = core.getBreakPoints();
-    QList <int>idList;
     if(!selectedItems.empty())
     {
         // Get the breakpoint
         QTreeWidgetItem *item = selectedItems[0];
-        int idx = item->data(0, Qt::UserRole).toInt();
-        if(0 <= idx && idx < bklist.size())
+        int number = item->data(0, Qt::UserRole).toInt();
+        BreakPoint* bk = core.findBreakPointByNumber(number);
+        if(bk && !bk->isWatchPoint())
         {
-            BreakPoint* bk = bklist[idx];
 
             // Show the breakpoint
             CodeViewTab* currentCodeViewTab = open(bk->m_fullname);
@@ -2165,6 +2406,23 @@ void MainWindow::onBreakpointsWidgetContextMenu(const QPoint& pos)
     action = m_popupMenu.addAction(title);
     connect(action, SIGNAL(triggered()), this, SLOT(onBreakpointsGoTo()));
     
+    // Add 'Set condition' and 'Set ignore count'
+    QTreeWidgetItem *item = bkptWidget->itemAt(pos);
+    if(item)
+    {
+        int number = item->data(0, Qt::UserRole).toInt();
+
+        title = "Set condition...";
+        action = m_popupMenu.addAction(title);
+        action->setData(number);
+        connect(action, SIGNAL(triggered()), this, SLOT(onBreakpointSetCondition()));
+
+        title = "Set ignore count...";
+        action = m_popupMenu.addAction(title);
+        action->setData(number);
+        connect(action, SIGNAL(triggered()), this, SLOT(onBreakpointSetIgnoreCount()));
+    }
+
     // Add 'Remove all breakpoints'
     title = "Remove all";
     action = m_popupMenu.addAction(title);
@@ -2242,25 +2500,7 @@ void MainWindow::onFuncFilterClear()
 
 void MainWindow::onFuncFilter_textChanged(const QString &text)
 {
-    // Create the search list
-    m_funcFilterText.clear();
-    QStringList list = text.split(";");
-    for(int i = 0;i < list.size();i++)
-    {
-        QString item = list[i].trimmed();
-        if(!item.isEmpty())
-        {
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-            QRegularExpression rx(QRegularExpression::wildcardToRegularExpression(item));
-#else
-            QRegExp rx(item);
-            rx.setPatternSyntax(QRegExp::Wildcard);
-#endif
-            m_funcFilterText.append(rx);
-        }
-    }
-    
-    fillInFuncList();
+    m_funcListModel.setFilterText(text);
 }
 
 
@@ -2292,25 +2532,7 @@ void MainWindow::onClassFilterClear()
 
 void MainWindow::onClassFilter_textChanged(const QString &text)
 {
-    // Create the search list
-    m_classFilterText.clear();
-    QStringList list = text.split(";");
-    for(int i = 0;i < list.size();i++)
-    {
-        QString item = list[i].trimmed();
-        if(!item.isEmpty())
-        {
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-            QRegularExpression rx(QRegularExpression::wildcardToRegularExpression(item));
-#else
-            QRegExp rx(item);
-            rx.setPatternSyntax(QRegExp::Wildcard);
-#endif
-            m_classFilterText.append(rx);
-        }
-    }
-    
-    fillInClassList();
+    m_classListModel.setFilterText(text);
 }
 
 void MainWindow::onIncSearch_textChanged(const QString &text)
@@ -2333,175 +2555,77 @@ void MainWindow::onIncSearch_textChanged(const QString &text)
  */
 void MainWindow::onAllTagScansDone()
 {
-    // Get all tags
-    m_tagList.clear();
-    for(int k = 0;k < m_sourceFiles.size();k++)
-    {
-        FileInfo &info = m_sourceFiles[k];
-
-        // Find the tag
-        QList<Tag> thisTagList;
-        m_tagManager.getTags(info.m_fullName, &thisTagList);
-        m_tagList += thisTagList;
-    }
-
     fillInClassList();
     fillInFuncList();
+
+    m_symbolSearchWidget.refresh();
 }
 
 
-void MainWindow::fillInClassList()
+/**
+ * @brief User has selected a symbol in the symbol search panel.
+ */
+void MainWindow::onSymbolActivated(QString filePath, int lineNo)
 {
-    // Get all classes
-    QStringList classList;
-    for(int i = 0;i < m_tagList.size();i++)
-    {
-        const Tag &tag = m_tagList[i];
-        QString className = tag.getClassName();
-        if(!className.isEmpty())
-            classList += tag.getClassName();
-    }
-    classList.removeDuplicates();
-    classList.sort();
-    
-    // Insert the classes in the class widget
-    QTreeWidget *classWidget = m_ui.treeWidget_classes;
-    classWidget->clear();
-    int totalClassFuncCount = 0;
-    for(int ci = 0;ci < classList.size();ci++)
-    {
-        QString className = classList[ci];
+    open(filePath, lineNo);
+}
 
-        bool isMatch = true;
-        
-        // Does the filter match the name?
-        for(int j = 0;j < m_classFilterText.size() && isMatch == true;j++)
-        {
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-            QRegularExpression &rx = m_classFilterText[j];
-            if(!rx.match(className).hasMatch())
-                isMatch = false;
-#else
-            QRegExp &rx = m_classFilterText[j];
-            if(rx.indexIn(className) == -1)
-                isMatch = false;
-#endif
-        }
 
-        if(isMatch)
-        {
-            // Insert the class
-            QTreeWidgetItem *classItem = new QTreeWidgetItem;
-            classItem->setText(0, className);
-            QBrush blueBrush (Qt::blue);
-            classItem->setForeground( 0, blueBrush);
-            classWidget->addTopLevelItem(classItem);
+/**
+ * @brief Returns the full path of all source files of the program.
+ */
+QStringList MainWindow::getSourceFilePaths()
+{
+    QStringList fileList;
+    for(int i = 0;i < m_sourceFiles.size();i++)
+        fileList.append(m_sourceFiles[i].m_fullName);
+    return fileList;
+}
 
 
-            // Add all functions to the class in the class widget
-            for(int i = 0;i < m_tagList.size();i++)
-            {
-                const Tag &tag = m_tagList[i];
-                if(tag.isFunc() && tag.getClassName() == className)
-                {
-                    QTreeWidgetItem *item = new QTreeWidgetItem;
-                    item->setText(0, tag.getName() + tag.getSignature());
-                    item->setData(0, Qt::UserRole, tag.getLineNo());
-                    item->setText(1, getFilenamePart(tag.getFilePath()));
-                    item->setData(1, Qt::UserRole, tag.getFilePath());
-                    item->setText(2, QString::number(tag.getLineNo()));
-                    classItem->addChild(item);
+void MainWindow::fillInClassList()
+{
+    m_classListModel.setClasses(m_tagManager.getIndex(), getSourceFilePaths());
+}
 
-                }
-            }
-            totalClassFuncCount += m_tagList.size();
-        }
-    
-    }
 
-    // Expand class treewidget?
-    if(totalClassFuncCount < CLASS_LIST_AUTO_EXPAND_COUNT)
-    {
-        for(int j = classWidget->topLevelItemCount()-1;j >= 0;--j)
-        {
-            QTreeWidgetItem * classItem = classWidget->topLevelItem(j);
-            classItem->setExpanded(true);
-        }
-    }
-    
+/**
+ * @brief Expands all classes in the class list if there are only a few functions shown.
+ */
+void MainWindow::expandClassList()
+{
+    if(m_classListModel.getVisibleChildCount() < CLASS_LIST_AUTO_EXPAND_COUNT)
+        m_ui.treeView_classes->expandAll();
 }
 
+
 void MainWindow::fillInFuncList()
 {
-    QTreeWidget *funcWidget = m_ui.treeWidget_functions;
-    funcWidget->clear();
-
-    // Add all functions to the treewidget
-    for(int i = 0;i < m_tagList.size();i++)
-    {
-        const Tag &tag = m_tagList[i];
-        if(tag.isFunc())
-        {
-            bool isMatch = true;
-
-            // Does the filter match the name?
-            QString name = tag.getLongName();
-            for(int j = 0;j < m_funcFilterText.size() && isMatch == true;j++)
-            {
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-                QRegularExpression &rx = m_funcFilterText[j];
-                if(!rx.match(name).hasMatch())
-                    isMatch = false;
-#else
-                QRegExp &rx = m_funcFilterText[j];
-                if(rx.indexIn(name) == -1)
-                    isMatch = false;
-#endif
-            }
-
-            // Add the item if it matches
-            if(isMatch)
-            {
-                QTreeWidgetItem *item = new QTreeWidgetItem;
-                if(tag.getClassName().isEmpty())
-                    item->setText(0, " " + name);
-                else
-                    item->setText(0, name);
-                item->setData(0, Qt::UserRole, tag.getLineNo());
-                item->setText(1, getFilenamePart(tag.getFilePath()));
-                item->setData(1, Qt::UserRole, tag.getFilePath());
-                item->setText(2, QString::number(tag.getLineNo()));
-                    
-                funcWidget->addTopLevelItem(item);
-            }
-        }
-    }
-    funcWidget->sortItems(0, Qt::AscendingOrder);
-
+    m_funcListModel.setFunctions(m_tagManager.getIndex(), getSourceFilePaths());
 }
 
-void MainWindow::onFuncWidgetItemSelected(QTreeWidgetItem * item, int column)
+/**
+ * @brief User has clicked on a function in the function list.
+ */
+void MainWindow::onFuncViewClicked(const QModelIndex &index)
 {
-    Q_UNUSED(column);
-
     // Get the linenumber and file where the function is defined in            
-    QString filePath = item->data(1, Qt::UserRole).toString();
-    int lineNo = item->data(0, Qt::UserRole).toInt();
-
-    open(filePath, lineNo);
+    QString filePath;
+    int lineNo;
+    if(m_funcListModel.getLocation(index, &filePath, &lineNo))
+        open(filePath, lineNo);
 }
 
 
-void MainWindow::onClassWidgetItemSelected(QTreeWidgetItem * item, int column)
+/**
+ * @brief User has clicked on a function in the class list.
+ */
+void MainWindow::onClassViewClicked(const QModelIndex &index)
 {
-    Q_UNUSED(column);
-
-    debugMsg("%s(item:%p column:%d)", __func__, item, column);
-
     // Get the linenumber and file where the function is defined in            
-    QString filePath = item->data(1, Qt::UserRole).toString();
-    int lineNo = item->data(0, Qt::UserRole).toInt();
-
-    open(filePath, lineNo);
+    QString filePath;
+    int lineNo;
+    if(m_classListModel.getLocation(index, &filePath, &lineNo))
+        open(filePath, lineNo);
 }
 
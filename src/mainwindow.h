@@ -12,7 +12,9 @@
 #include <QMainWindow>
 #include <QApplication>
 #include <QMap>
+#include <QHash>
 #include <QLabel>
+#include <QTimer>
 
 #if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
 #include <QRegularExpression>
@@ -30,6 +32,12 @@
 #include "watchvarctl.h"
 #include "codeviewtab.h"
 #include "tagmanager.h"
+#include "symbolsearchwidget.h"
+#include "taglistmodel.h"
+#include "sourcetreemodel.h"
+#include "threadlistmodel.h"
+#include "stackframemodel.h"
+#include "breakpointsaver.h"
 #include "log.h"
 
 
@@ -57,16 +65,22 @@ public:
 public:
     void insertSourceFiles();
     void setStatusLine(Settings &cfg);
+    void setSymbolsLoading(bool loading);
     
 public:
     void ICore_onStopped(ICore::StopReason reason, QString path, int lineNo);
     void ICore_onLocalVarChanged(QStringList varNames);
     void ICore_onWatchVarChanged(VarWatch &watch);
     void ICore_onConsoleStream(QString text);
-    void ICore_onBreakpointsChanged();
-    void ICore_onThreadListChanged();
+    void ICore_onBreakpointAdded(BreakPoint *bkpt);
+    void ICore_onBreakpointModified(BreakPoint *bkpt);
+    void ICore_onBreakpointDeleted(int number);
+    void ICore_onWatchPointTriggered(WatchPointHit hit);
+    void ICore_onThreadAdded(ThreadInfo info);
+    void ICore_onThreadChanged(ThreadInfo info);
+    void ICore_onThreadRemoved(int threadId);
     void ICore_onCurrentThreadChanged(int threadId);
-    void ICore_onStackFrameChange(QList<StackFrameEntry> stackFrameList);
+    void ICore_onStackDepthChanged(int depth);
     void ICore_onFrameVarReset();
     void ICore_onFrameVarChanged(QString name, QString value);
     void ICore_onMessage(QString message);
@@ -75,6 +89,7 @@ public:
     void ICore_onTargetOutput(QString msg);
     void ICore_onStateChanged(TargetState state);
     void ICore_onSourceFileListChanged();
+    void ICore_onSourceFilesUpdated(QStringList addedList, QStringList removedList);
     void ICore_onSourceFileChanged(QString filename);
 
     void ICodeView_onRowDoubleClick(int lineNo);
@@ -99,16 +114,28 @@ private:
     void showWidgets();
     void fillInFuncList();
     void fillInClassList();
+    QStringList getSourceFilePaths();
     
 public:
         
 private:
+    enum
+    {
+        BKPT_COLUMN_FILENAME = 0,
+        BKPT_COLUMN_LINE,
+        BKPT_COLUMN_FUNC,
+        BKPT_COLUMN_ADDR,
+        BKPT_COLUMN_HITS,
+        BKPT_COLUMN_CONDITION,
+        BKPT_COLUMN_ENABLED,
+        BKPT_COLUMN_COUNT
+    };
+    void setBreakpointItem(QTreeWidgetItem *item, BreakPoint *bkpt);
+    void updateBreakpointMarkers(QString fullPath);
+
     void setConfig();
     
-    void wrapSourceTree(QTreeWidget *treeWidget);
-
-    QTreeWidgetItem *addTreeWidgetPath(QTreeWidget *treeWidget, QTreeWidgetItem *parent, QString path);
-    void fillInStack();
+    void updatePanelInterest();
 
     bool eventFilter(QObject *obj, QEvent *event);
     void loadConfig();
@@ -140,9 +167,15 @@ public slots:
     void onClassFilter_textChanged(const QString &text);
 
     void onIncSearch_textChanged(const QString &text);
-    void onFolderViewItemActivated ( QTreeWidgetItem * item, int column );
+    void onFolderViewItemActivated(const QModelIndex &index);
+    void onSourceFilesChecked(int generation, QStringList nameList, QStringList fullNameList,
+                            QStringList removedList, bool isUpdate);
+    void onBreakpointSaveTimeout();
     void onThreadWidgetSelectionChanged( );
+    void onThreadFramesRequested(QList<int> threadIdList);
+    void onThreadViewDoubleClicked(const QModelIndex &index);
     void onStackWidgetSelectionChanged();
+    void onStackFramesRequested(int lowFrame, int highFrame);
     void onQuit();
     void onNext();
     void onStepIn();
@@ -158,12 +191,18 @@ public slots:
     void onBreakpointsWidgetItemDoubleClicked(QTreeWidgetItem * item,int column);
     void onRestart();
     void onContinue();
+    void onNextMany();
+    void onNextUntil();
+    void onContinueHits();
     void onCodeViewContextMenuAddWatch();
     void onCodeViewContextMenuOpenFile();
     void onCodeViewContextMenuShowDefinition();
     void onCodeViewContextMenuShowCurrentLocation();
     void onSettings();
     void onCodeViewContextMenuToggleBreakpoint();
+    void onCodeViewContextMenuAddLogPoint();
+    void onBreakpointSetCondition();
+    void onBreakpointSetIgnoreCount();
     void onCodeViewTab_tabCloseRequested ( int index );
     void onCodeViewTab_currentChanged( int tabIdx);
     void onCodeViewTab_launchContextMenu(const QPoint&);
@@ -175,6 +214,8 @@ public slots:
 
     void onViewStack();
     void onViewBreakpoints();
+    void onViewWatchpointLog();
+    void onPanelTabChanged(int index);
     void onViewThreads();
     void onViewWatch();
     void onViewAutoVariables();
@@ -192,8 +233,10 @@ public slots:
     void onBreakpointsWidgetContextMenu(const QPoint& pt);
 
     void onAllTagScansDone();
-    void onFuncWidgetItemSelected(QTreeWidgetItem * item, int column);
-    void onClassWidgetItemSelected(QTreeWidgetItem * item, int column);
+    void onSymbolActivated(QString filePath, int lineNo);
+    void onFuncViewClicked(const QModelIndex &index);
+    void onClassViewClicked(const QModelIndex &index);
+    void expandClassList();
 
     
     void onNewInfoMsg(QString text);
@@ -221,21 +264,25 @@ private:
     QIcon m_folderIcon;
     QString m_currentFile; //!< The file which the program counter points to.
     int m_currentLine; //!< The linenumber (first=1) which the program counter points to.
-    QList<StackFrameEntry> m_stackFrameList;
     QMenu m_popupMenu;
-#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
-    QVector<QRegularExpression> m_funcFilterText; //!< Filter for the function list.
-    QVector<QRegularExpression> m_classFilterText; //!< Filter for the class list.
-#else
-    QVector<QRegExp> m_funcFilterText; //!< Filter for the function list.
-    QVector<QRegExp> m_classFilterText; //!< Filter for the class list.
-#endif
+    TagListModel m_funcListModel; //!< Model for the function list.
+    TagListModel m_classListModel; //!< Model for the class list.
+    SourceTreeModel m_fileTreeModel; //!< Model for the source file tree.
+    ThreadListModel m_threadListModel; //!< Model for the thread list.
+    StackFrameModel m_stackFrameModel; //!< Model for the stack of the current thread.
+    SourceFileChecker m_sourceFileChecker;
+    int m_sourceFileGeneration; //!< Incremented each time the source files are checked.
+    BreakpointSaver m_breakpointSaver;
+    QTimer m_breakpointSaveTimer; //!< Delays the saving of the breakpoints.
+    QStringList m_savedBreakpoints; //!< The breakpoints that was last saved.
+    QHash<int, QTreeWidgetItem*> m_breakpointItems; //!< Breakpoint number => item in the breakpoint list widget
+    QString m_nextUntilExpression; //!< The last expression used in "Next until expression is true".
+    QList<QAction*> m_loadingDisabledActions; //!< Actions disabled while the symbols are loaded.
 
     
     Settings m_cfg;
     TagManager m_tagManager;
     QList<FileInfo> m_sourceFiles;
-    QList<Tag> m_tagList; // Current list of tags
     
     AutoVarCtl m_autoVarCtl;
     WatchVarCtl m_watchVarCtl;
@@ -244,6 +291,7 @@ private:
     QFont m_gedeOutputFont;
     QLabel m_statusLineWidget;
     Locator m_locator;
+    SymbolSearchWidget m_symbolSearchWidget;
 };
 
 
@@ -28,6 +28,19 @@ QByteArray MemoryDialog::getMemory(quint64 startAddress, int count)
     return b;
 }
 
+
+void MemoryDialog::setWatchPoint(quint64 startAddress, int count, bool onRead, bool onWrite, bool autoContinue)
+{
+    Core &core = Core::getInstance();
+
+    BreakPoint::WatchType type = BreakPoint::WATCH_WRITE;
+    if(onRead && onWrite)
+        type = BreakPoint::WATCH_ACCESS;
+    else if(onRead)
+        type = BreakPoint::WATCH_READ;
+    core.gdbSetMemoryWatchPoint(startAddress, count, type, autoContinue);
+}
+
 MemoryDialog::MemoryDialog(QWidget *parent)
     : QDialog(parent)
 {
@@ -15,6 +15,7 @@ public:
     MemoryDialog(QWidget *parent = NULL);
 
     virtual QByteArray getMemory(quint64 startAddress, int count);
+    virtual void setWatchPoint(quint64 startAddress, int count, bool onRead, bool onWrite, bool autoContinue);
     void setStartAddress(quint64 addr);
 
     void setConfig(Settings *cfg);
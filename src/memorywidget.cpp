@@ -403,6 +403,17 @@ void MemoryWidget::mousePressEvent(QMouseEvent * event)
         QAction *action = m_popupMenu.addAction("Copy");
         connect(action, SIGNAL(triggered()), this, SLOT(onCopy()));
 
+        // Add watchpoints on the selection
+        m_popupMenu.addSeparator();
+        action = m_popupMenu.addAction("Break when changed");
+        connect(action, SIGNAL(triggered()), this, SLOT(onBreakOnWrite()));
+        action = m_popupMenu.addAction("Break when read");
+        connect(action, SIGNAL(triggered()), this, SLOT(onBreakOnRead()));
+        action = m_popupMenu.addAction("Break when accessed");
+        connect(action, SIGNAL(triggered()), this, SLOT(onBreakOnAccess()));
+        action = m_popupMenu.addAction("Log changes without stopping");
+        connect(action, SIGNAL(triggered()), this, SLOT(onLogWrites()));
+
         m_popupMenu.popup(pos);
 
     }
@@ -418,20 +429,63 @@ void MemoryWidget::mousePressEvent(QMouseEvent * event)
 
 
 
-void MemoryWidget::onCopy()
+/**
+ * @brief Returns the first and the last address of the selection.
+ */
+void MemoryWidget::getSelection(quint64 *selectionFirst, quint64 *selectionLast)
 {
-    quint64 selectionFirst,selectionLast;
-    
     if(m_selectionEnd < m_selectionStart)
     {
-        selectionFirst = m_selectionEnd;
-        selectionLast = m_selectionStart;
+        *selectionFirst = m_selectionEnd;
+        *selectionLast = m_selectionStart;
     }
     else
     {
-        selectionFirst = m_selectionStart;
-        selectionLast = m_selectionEnd;
+        *selectionFirst = m_selectionStart;
+        *selectionLast = m_selectionEnd;
     }
+}
+
+
+/**
+ * @brief Sets a watchpoint on the selected memory.
+ */
+void MemoryWidget::setWatchPoint(bool onRead, bool onWrite, bool autoContinue)
+{
+    quint64 selectionFirst,selectionLast;
+    getSelection(&selectionFirst, &selectionLast);
+
+    if(m_inf)
+        m_inf->setWatchPoint(selectionFirst, selectionLast-selectionFirst+1, onRead, onWrite, autoContinue);
+}
+
+
+void MemoryWidget::onBreakOnWrite()
+{
+    setWatchPoint(false, true, false);
+}
+
+void MemoryWidget::onBreakOnRead()
+{
+    setWatchPoint(true, false, false);
+}
+
+void MemoryWidget::onBreakOnAccess()
+{
+    setWatchPoint(true, true, false);
+}
+
+void MemoryWidget::onLogWrites()
+{
+    setWatchPoint(false, true, true);
+}
+
+
+void MemoryWidget::onCopy()
+{
+    quint64 selectionFirst,selectionLast;
+    
+    getSelection(&selectionFirst, &selectionLast);
 
     if(m_inf)
     {
@@ -14,6 +14,7 @@ class IMemoryWidget
 {
 public:
     virtual QByteArray getMemory(quint64 startAddress, int count) = 0;
+    virtual void setWatchPoint(quint64 startAddress, int count, bool onRead, bool onWrite, bool autoContinue) = 0;
 
 };
 
@@ -36,12 +37,18 @@ private:
     quint64 getAddrAtPos(QPoint pos);
     int getHeaderHeight();
     char byteToChar(quint8 d);
+    void getSelection(quint64 *selectionFirst, quint64 *selectionLast);
+    void setWatchPoint(bool onRead, bool onWrite, bool autoContinue);
 
     virtual void keyPressEvent(QKeyEvent *e);
     
 public slots:
     void setStartAddress(quint64 addr);
     void onCopy();
+    void onBreakOnWrite();
+    void onBreakOnRead();
+    void onBreakOnAccess();
+    void onLogWrites();
     
 private:
     void mousePressEvent(QMouseEvent * event);
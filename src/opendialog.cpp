@@ -382,6 +382,14 @@ void OpenDialog::saveConfig(Settings *cfg)
         cfg->m_reloadBreakpoints = true;
     else
         cfg->m_reloadBreakpoints = false;
+    if(dlg.m_ui.checkBox_loadSymbolsInBackground->checkState() == Qt::Checked)
+        cfg->m_loadSymbolsInBackground = true;
+    else
+        cfg->m_loadSymbolsInBackground = false;
+    if(dlg.m_ui.checkBox_useIndexCache->checkState() == Qt::Checked)
+        cfg->m_useIndexCache = true;
+    else
+        cfg->m_useIndexCache = false;
     
     cfg->m_projDir = getProjectDir();
 
@@ -426,6 +434,8 @@ void OpenDialog::loadConfig(Settings &cfg)
     dlg.setGdbPath(cfg.m_gdbPath);
 
     dlg.m_ui.checkBox_reloadBreakpoints->setChecked(cfg.m_reloadBreakpoints);
+    dlg.m_ui.checkBox_loadSymbolsInBackground->setChecked(cfg.m_loadSymbolsInBackground);
+    dlg.m_ui.checkBox_useIndexCache->setChecked(cfg.m_useIndexCache);
 
     dlg.setCoreDumpFile(cfg.m_coreDumpFile);
 
@@ -12,6 +12,7 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 #include <QStringList>
 #include <QFile>
 
@@ -22,123 +23,126 @@
 
 RustTagScanner::RustTagScanner()
     : m_cfg(NULL)
-
+    ,m_data(NULL)
+    ,m_tokenIdx(0)
 {
-    QStringList keywordList = Settings::getDefaultRustKeywordList();
-    for(int u = 0;u < keywordList.size();u++)
-    {
-        m_keywords[keywordList[u]] = true;
-    }
-
-
-
 }
 
 RustTagScanner::~RustTagScanner()
 {
-    clearTokenList();
 }
 
-    
+
 int RustTagScanner::scan(QString filepath, QList<Tag> *taglist)
 {
     m_filepath = filepath;
-    
+
     // Open file
     QFile file(filepath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    if (!file.open(QIODevice::ReadOnly))
     {
         errorMsg("Failed to open '%s'", stringToCStr(filepath));
         return -1;
     }
 
-    // Read file content
-    QString text;
-    while (!file.atEnd())
+    // Map the file content (or read it if the file can not be mapped)
+    QByteArray content;
+    int size = (int)file.size();
+    uchar *mapped = (size > 0) ? file.map(0, size) : NULL;
+    if(mapped)
+        m_data = (const char*)mapped;
+    else
     {
-         QByteArray line = file.readLine();
-         text += line;
+        content = file.readAll();
+        m_data = content.constData();
+        size = content.size();
     }
 
-    tokenize(text);
+    tokenize(m_data, size);
 
     parse(taglist);
 
+    // Keep the allocated tokens for the next file
+    m_tokens.resize(0);
+    m_data = NULL;
 
-    clearTokenList();
-
+    if(mapped)
+        file.unmap(mapped);
 
     return 0;
 }
 
 
-RustTagScanner::Token* RustTagScanner::pushToken(char c, Token::Type type, int lineNr)
+void RustTagScanner::pushToken(Token::Type type, int start, int length, int lineNr)
 {
-    QString text(c);
-    return pushToken(text, type, lineNr);
+    m_tokens.append(Token(type, start, length, lineNr));
 }
 
 
-RustTagScanner::Token* RustTagScanner::pushToken(QString text, Token::Type type, int lineNr)
+const RustTagScanner::Token* RustTagScanner::popToken()
 {
-    Token *tok = new Token(lineNr, type);
-    tok->setText(text);
-    m_tokens.append(tok);
-    return tok;
+    if(m_tokenIdx >= m_tokens.size())
+        return NULL;
+    return &m_tokens[m_tokenIdx++];
 }
 
-
-
-    
-RustTagScanner::Token* RustTagScanner::popToken()
+const RustTagScanner::Token* RustTagScanner::peekToken()
 {
-    if(m_tokens.isEmpty())
+    if(m_tokenIdx >= m_tokens.size())
         return NULL;
-    Token* tok = m_tokens.takeFirst();
-    return tok;
+    return &m_tokens[m_tokenIdx];
 }
 
-RustTagScanner::Token* RustTagScanner::peekToken()
+
+/**
+ * @brief Returns the text of a token.
+ */
+QString RustTagScanner::getText(const Token *tok) const
 {
-    if(m_tokens.isEmpty())
-        return NULL;
-    return m_tokens.first();
+    return QString::fromUtf8(m_data + tok->m_start, tok->m_length);
 }
 
 
+/**
+ * @brief Checks if a token has a specific text.
+ */
+bool RustTagScanner::isText(const Token *tok, const char *text) const
+{
+    int len = strlen(text);
+    if(tok->m_length != len)
+        return false;
+    return (memcmp(m_data + tok->m_start, text, len) == 0) ? true : false;
+}
+
 
-QString RustTagScanner::Token::toDesc()
+QString RustTagScanner::toDesc(const Token *tok) const
 {
-    Token *tok = this;
     QString typeStr;
     switch(tok->getType())
     {
         case Token::STRING: typeStr = "STRING";break;
         case Token::NUMBER: typeStr = "NUMBER";break;
-        case Token::COMMENT: typeStr = "COMMENT";break;
         case Token::WORD: typeStr = "WORD";break;
-        case Token::KEYWORD: typeStr = "KEYWORD";break;
     };
-        
+
     QString str;
-    str = QString::asprintf("[L%d;%s>%s<]", tok->m_lineNr, qPrintable(typeStr), qPrintable(tok->text));
+    str = QString::asprintf("[L%d;%s>%s<]", tok->getLineNr(), qPrintable(typeStr), qPrintable(getText(tok)));
     return str;
 }
 
 
 /**
  * @brief Removes a token if it matches.
- * @return false if a token was poped. 
+ * @return false if a token was poped.
  */
-bool RustTagScanner::eatToken(QString text)
+bool RustTagScanner::eatToken(const char *text)
 {
-   Token *tok = peekToken();
+    const Token *tok = peekToken();
     if(!tok)
         return true;
-    if(tok->getText() == text)
+    if(isText(tok, text))
     {
-        tok = popToken();
-        delete tok;
+        popToken();
         return false;
     }
     return true;
@@ -146,9 +150,10 @@ bool RustTagScanner::eatToken(QString text)
 
 void RustTagScanner::parse(QList<Tag> *taglist)
 {
-    
-    Token *tok;
+
+    const Token *tok;
     enum { IDLE, FN_KW} state = IDLE;
+    m_tokenIdx = 0;
     do
     {
         tok = popToken();
@@ -158,18 +163,18 @@ void RustTagScanner::parse(QList<Tag> *taglist)
             {
                 case IDLE:
                 {
-                    debugMsg("tok: %s", qPrintable(tok->toDesc()));
-                    if(tok->getText() == "fn")
+                    debugMsg("tok: %s", qPrintable(toDesc(tok)));
+                    if(isText(tok, "fn"))
                         state = FN_KW;
                 };break;
                 case FN_KW:
                 {
-                    debugMsg("found: '%s' at L%d", qPrintable(tok->getText()), tok->getLineNr());
                     Tag tag;
                     tag.setLineNo(tok->getLineNr());
-                    tag.m_name = tok->getText();
+                    tag.m_name = getText(tok);
                     tag.m_filepath = m_filepath;
                     tag.m_type = Tag::TAG_FUNC;
+                    debugMsg("found: '%s' at L%d", qPrintable(tag.m_name), tok->getLineNr());
                     state = IDLE;
 
                     // Parse signature
@@ -178,24 +183,20 @@ void RustTagScanner::parse(QList<Tag> *taglist)
                     }
                     else
                     {
-                        QString tokText;
                         QString signature;
                         signature += "(";
+                        const Token *tok2;
                         do
                         {
-                            Token *tok2 = popToken();
+                            tok2 = popToken();
                             if(tok2)
                             {
-                                tokText = tok2->getText();
-                                signature += tokText;
-                                if(tokText == ",")
+                                signature += getText(tok2);
+                                if(isText(tok2, ","))
                                     signature += " ";
-                                delete tok2;
                             }
-                            else
-                                tokText = "";
-                            
-                        }while(tokText != ")");
+
+                        }while(tok2 && !isText(tok2, ")"));
 
                         debugMsg("Found signature:%s", qPrintable(signature));
                         tag.setSignature(signature);
@@ -203,32 +204,14 @@ void RustTagScanner::parse(QList<Tag> *taglist)
 
                     // Add the tag to the list
                     taglist->append(tag);
-                
+
                 };break;
                 default:;break;
             }
-            delete tok;
         }
     }while(tok);
 
 }
-    
-
-
-
-
-void RustTagScanner::clearTokenList()
-{
-    for(int i = 0;i < m_tokens.size();i++)
-    {
-        Token* tok = m_tokens[i];
-        delete tok;
-    }
-    m_tokens.clear();
-
-
-
-}
 
 
 bool RustTagScanner::isSpecialChar(char c) const
@@ -251,33 +234,6 @@ bool RustTagScanner::isSpecialChar(char c) const
         return false;
 }
 
-bool RustTagScanner::isSpecialChar(TextField *field) const
-{
-    if(field->m_text.size() == 1)
-    {
-        return isSpecialChar(field->m_text[0].toLatin1());
-    }
-    return false;
-}
-
-
-
-
-bool RustTagScanner::isKeyword(QString text) const
-{
-    if(text.size() == 0)
-        return false;
-    if(m_keywords.contains(text))
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
-}
-
-
 
 void RustTagScanner::setConfig(Settings *cfg)
 {
@@ -285,209 +241,89 @@ void RustTagScanner::setConfig(Settings *cfg)
 
 }
 
-void RustTagScanner::tokenize(QString text2)
+
+/**
+ * @brief Splits the (UTF-8) file content into tokens.
+ *
+ * Comments and whitespaces are skipped.
+ */
+void RustTagScanner::tokenize(const char *data, int size)
 {
     int lineNr = 1;
-    enum {IDLE,
-        MULTI_COMMENT,
-        SPACES,
-        WORD, COMMENT1,COMMENT,
-        STRING,
-        ESCAPED_CHAR,
-        MINUS
-    } state = IDLE;
-    char c = '\n';
-    char prevC = ' ';
-    char prevPrevC = ' ';
-    bool isEscaped = false;
-    QString text;
-
-
-    clearTokenList();
-    
-
-    for(int i = 0;i < text2.size();i++)
-    {
-        c = text2[i].toLatin1();
+    int i = 0;
 
-        if(prevC != '\\' && c == '\n')
-            lineNr++;
+    m_tokens.resize(0);
 
-        // Was the last character an escape?
-        if(prevC == '\\' && prevPrevC != '\\')
-            isEscaped = true;
-        else
-            isEscaped = false;
-        prevPrevC = prevC;
-        
-        
-        switch(state)
-        {   
-            case IDLE:
-            {
-                text = "";
-                if(c == '/')
-                {
-                    text = "/";
-                    state = COMMENT1;
-                }
-                else if(c == ' ' || c == '\t')
-                {
-                    state = SPACES;
-                }
-                else if(c == '\'')
-                {
-                    state = ESCAPED_CHAR;
-                }
-                else if(c == '"')
-                {
-                    state = STRING;
-                }
-                // An '->' token?
-                else if(c == '-')
-                {
-                    state = MINUS;
-                }
-                else if(isSpecialChar(c))
-                {
-                    pushToken(c, Token::WORD, lineNr);
-                }
-                else if(c == '\n')
-                {
-                    state = IDLE;
-                }
-                else
-                {
-                    text = c;
-                    state = WORD;
-                }
-            };break;
-            case MINUS:
-            {
-                if(c == '>')
-                {
-                    pushToken("->", Token::WORD, lineNr);
-                }
-                else
-                {
-                    pushToken(c, Token::WORD, lineNr);
-                }
-                state = IDLE;
-            };break;
-            case COMMENT1:
-            {
-                if(c == '*')
-                {
-                    text += c;
-                    state = MULTI_COMMENT;
-                    
-                }
-                else if(c == '/')
-                {
-                    text += c;
-                    state = COMMENT;
-                }
-                else
-                {
-                    i--;
-                    state = IDLE;
-                }
-            };break;
-            case MULTI_COMMENT:
-            {
-                
-                if(c == '\n')
-                {
-                    pushToken(text, Token::COMMENT, lineNr);
-                    text = "";
-                }
-                else if(prevC == '*' && c == '/')
-                {
-                    text += c;
-                    pushToken(text, Token::COMMENT, lineNr);
-                    state = IDLE;
-                }
-                else
-                {
-                    text += c;
-                }
-            };break;
-            case COMMENT:
-            {
-                if(c == '\n')
-                {
-                    pushToken(text, Token::COMMENT, lineNr-1);
-                    state = IDLE;
-                }
-                else
-                    text += c;
-                    
-            };break;
-            case SPACES:
-            {
-                if(c == ' ' || c == '\t')
-                {
-                                                              
-                }
-                else
-                {
-                    i--;
-                    state = IDLE;
-                }  
-            };break;
-            case ESCAPED_CHAR:
+    while(i < size)
+    {
+        char c = data[i];
+        if(c == '\n')
+        {
+            lineNr++;
+            i++;
+        }
+        else if(c == ' ' || c == '\t' || c == '\r')
+            i++;
+        // Comment?
+        else if(c == '/' && i+1 < size && data[i+1] == '/')
+        {
+            while(i < size && data[i] != '\n')
+                i++;
+        }
+        else if(c == '/' && i+1 < size && data[i+1] == '*')
+        {
+            i += 2;
+            while(i < size && !(data[i] == '*' && i+1 < size && data[i+1] == '/'))
             {
-                text += c;
-                if(!isEscaped && c == '\'')
-                {
-                    pushToken(text, Token::STRING, lineNr);
-                    state = IDLE;
-                }
-            };break;
-            case STRING:
+                if(data[i] == '\n')
+                    lineNr++;
+                i++;
+            }
+            i += 2;
+        }
+        // A string or a character (but not a lifetime such as 'a)?
+        else if(c == '"' ||
+            (c == '\'' && i+2 < size && (data[i+1] == '\\' || data[i+2] == '\'')))
+        {
+            int start = i;
+            int startLineNr = lineNr;
+            for(i = i+1;i < size && data[i] != c;i++)
             {
-                text += c;
-                if(!isEscaped && c == '"')
-                {
-                    pushToken(text, Token::STRING, lineNr);
-                    state = IDLE;
-                }
-                  
-            };break;
-            case WORD:
+                if(data[i] == '\\' && i+1 < size)
+                    i++;
+                if(data[i] == '\n')
+                    lineNr++;
+            }
+            if(i < size)
+                i++;
+            pushToken(Token::STRING, start, i-start, startLineNr);
+        }
+        // An '->' token?
+        else if(c == '-' && i+1 < size && data[i+1] == '>')
+        {
+            pushToken(Token::WORD, i, 2, lineNr);
+            i += 2;
+        }
+        else if(isSpecialChar(c))
+        {
+            pushToken(Token::WORD, i, 1, lineNr);
+            i++;
+        }
+        else
+        {
+            int start = i;
+            for(i = i+1;i < size;i++)
             {
-                if(isSpecialChar(c) || c == ' ' || c == '\t' || c == '\n')
-                {
-                    if(c != '\n')
-                        i--;
-
-                    if(QChar(text[0]).isDigit())
-                        pushToken(text, Token::NUMBER, lineNr);
-                    else
-                    {
-                     
-                        if(isKeyword(text))
-                            pushToken(text, Token::KEYWORD, lineNr);
-                        else
-                            pushToken(text, Token::WORD, lineNr);
-                    }
-
-                    state = IDLE;
-                }
-                else
-                {
-                    
-                    text += c;
-                }
-                
-            };break;
+                c = data[i];
+                if(isSpecialChar(c) || c == ' ' || c == '\r' || c == '\n' || c == '"')
+                    break;
+            }
+            if(data[start] >= '0' && data[start] <= '9')
+                pushToken(Token::NUMBER, start, i-start, lineNr);
+            else
+                pushToken(Token::WORD, start, i-start, lineNr);
         }
-        prevC = c;
     }
-
-    
 }
 
 
-
-
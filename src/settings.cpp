@@ -10,6 +10,8 @@
 #include "settings.h"
 
 #include <QDir>
+#include <QMutex>
+#include <QMutexLocker>
 #ifdef QT_WIDGETS_LIB
 #include <QStyleFactory>
 #endif
@@ -24,6 +26,10 @@
 
 QString Settings::g_projConfigFilename = PROJECT_CONFIG_FILENAME;
 
+// Serializes the read-modify-write of the project config file since the
+// breakpoints are saved from a separate thread.
+static QMutex g_projConfigMutex;
+
 
 Settings::Settings()
 : m_globalProjConfig(false),
@@ -33,6 +39,7 @@ Settings::Settings()
     m_viewWindowStack = true;
     m_viewWindowThreads = true;
     m_viewWindowBreakpoints = true;
+    m_viewWindowWatchpointLog = true;
     m_viewWindowWatch = true;
     m_viewWindowAutoVariables = true;
     m_viewWindowTargetOutput = true;
@@ -229,6 +236,7 @@ void Settings::loadGlobalConfig()
     m_viewWindowStack = tmpIni.getBool("GuiState/EnableWindowStack", m_viewWindowStack);
     m_viewWindowThreads = tmpIni.getBool("GuiState/EnableWindowThreads", m_viewWindowThreads);
     m_viewWindowBreakpoints = tmpIni.getBool("GuiState/EnableWindowBreakpoints", m_viewWindowBreakpoints);
+    m_viewWindowWatchpointLog = tmpIni.getBool("GuiState/EnableWindowWatchpointLog", m_viewWindowWatchpointLog);
     m_viewWindowWatch = tmpIni.getBool("GuiState/EnableWindowWatch", m_viewWindowWatch);
     m_viewWindowAutoVariables = tmpIni.getBool("GuiState/EnableWindowAuto", m_viewWindowAutoVariables);
     m_viewWindowTargetOutput = tmpIni.getBool("GuiState/EnableWindowTargetOutput", m_viewWindowTargetOutput);
@@ -306,6 +314,9 @@ void Settings::loadProjectConfig(QString filepath)
     m_runningPid = tmpIni.getInt("RunningPid", 0);
         
     m_reloadBreakpoints = tmpIni.getBool("ReuseBreakpoints", false);
+    m_loadSymbolsInBackground = tmpIni.getBool("LoadSymbolsInBackground", false);
+    m_useIndexCache = tmpIni.getBool("UseIndexCache", true);
+    m_askToAddSymbolIndex = tmpIni.getBool("AskToAddSymbolIndex", true);
 
     m_initialBreakpoint = tmpIni.getString("InitialBreakpoint","main");
 
@@ -353,6 +364,8 @@ void Settings::saveProjectConfig()
 
     debugMsg("Saving config to %s", qPrintable(filepath));
 
+    QMutexLocker locker(&g_projConfigMutex);
+
     Ini tmpIni;
 
     tmpIni.appendLoad(filepath);
@@ -376,6 +389,9 @@ void Settings::saveProjectConfig()
     tmpIni.setStringList("LastProgramArguments", tmpArgs);
     
     tmpIni.setBool("ReuseBreakpoints", m_reloadBreakpoints);
+    tmpIni.setBool("LoadSymbolsInBackground", m_loadSymbolsInBackground);
+    tmpIni.setBool("UseIndexCache", m_useIndexCache);
+    tmpIni.setBool("AskToAddSymbolIndex", m_askToAddSymbolIndex);
 
     tmpIni.setString("InitialBreakpoint",m_initialBreakpoint);
 
@@ -383,10 +399,24 @@ void Settings::saveProjectConfig()
 
     
     //
+    tmpIni.setStringList("Breakpoints", breakpointsToStringList(m_breakpoints));
+
+
+    if(tmpIni.save(filepath))
+        infoMsg("Failed to save '%s'", stringToCStr(filepath));
+
+}
+
+
+/**
+ * @brief Returns the breakpoints as they are stored in the project config file.
+ */
+QStringList Settings::breakpointsToStringList(QList<SettingsBreakpoint> list)
+{
     QStringList breakpointStringList;
-    for(int i = 0;i < m_breakpoints.size();i++)
+    for(int i = 0;i < list.size();i++)
     {
-        SettingsBreakpoint bkptCfg = m_breakpoints[i];
+        SettingsBreakpoint bkptCfg = list[i];
         QString field;
         field = bkptCfg.m_filename;
         field += ":";
@@ -395,12 +425,32 @@ void Settings::saveProjectConfig()
         field += lineNoStr;
         breakpointStringList.push_back(field);
     }
-    tmpIni.setStringList("Breakpoints", breakpointStringList);
+    return breakpointStringList;
+}
+
+
+/**
+ * @brief Updates the breakpoints in a project config file.
+ *
+ * Only the breakpoint entry is changed, the rest of the file is kept as is.
+ * Safe to call from any thread.
+ * @return 0 on success.
+ */
+int Settings::saveBreakpoints(QString filepath, QStringList breakpointStringList)
+{
+    debugMsg("Saving %d breakpoints to %s", breakpointStringList.size(), qPrintable(filepath));
 
+    QMutexLocker locker(&g_projConfigMutex);
 
+    Ini tmpIni;
+    tmpIni.appendLoad(filepath);
+    tmpIni.setStringList("Breakpoints", breakpointStringList);
     if(tmpIni.save(filepath))
+    {
         infoMsg("Failed to save '%s'", stringToCStr(filepath));
-
+        return 1;
+    }
+    return 0;
 }
 
 
@@ -457,6 +507,7 @@ void Settings::saveGlobalConfig()
     tmpIni.setBool("GuiState/EnableWindowStack", m_viewWindowStack);
     tmpIni.setBool("GuiState/EnableWindowThreads", m_viewWindowThreads);
     tmpIni.setBool("GuiState/EnableWindowBreakpoints", m_viewWindowBreakpoints);
+    tmpIni.setBool("GuiState/EnableWindowWatchpointLog", m_viewWindowWatchpointLog);
     tmpIni.setBool("GuiState/EnableWindowWatch", m_viewWindowWatch);
     tmpIni.setBool("GuiState/EnableWindowAuto", m_viewWindowAutoVariables);
     tmpIni.setBool("GuiState/EnableWindowTargetOutput", m_viewWindowTargetOutput);
@@ -67,6 +67,9 @@ class Settings
         
         void loadProjectConfig(QString path);
 
+        static QStringList breakpointsToStringList(QList<SettingsBreakpoint> list);
+        static int saveBreakpoints(QString filepath, QStringList breakpointStringList);
+
         QString getProjectDir() const { return m_projDir; };
     private:
         void loadGlobalConfig();
@@ -102,6 +105,9 @@ class Settings
         QStringList m_sourceIgnoreDirs;
 
         bool m_reloadBreakpoints;
+        bool m_loadSymbolsInBackground;
+        bool m_useIndexCache;
+        bool m_askToAddSymbolIndex; //!< Ask to generate a symbol index for programs without one.
         QString m_initialBreakpoint;
         
         QList<SettingsBreakpoint> m_breakpoints;
@@ -127,6 +133,7 @@ class Settings
         bool m_viewWindowStack;
         bool m_viewWindowThreads;
         bool m_viewWindowBreakpoints;
+        bool m_viewWindowWatchpointLog;
         bool m_viewWindowWatch;
         bool m_viewWindowAutoVariables;
         bool m_viewWindowTargetOutput;
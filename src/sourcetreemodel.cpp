@@ -0,0 +1,651 @@
+/*
+ * Copyright (C) 2014-2020 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "sourcetreemodel.h"
+
+#include <QFileInfo>
+#include <algorithm>
+#include <QMutexLocker>
+
+#include "util.h"
+#include "log.h"
+
+
+PrefixTrie::PrefixTrie()
+{
+}
+
+PrefixTrie::~PrefixTrie()
+{
+}
+
+
+void PrefixTrie::insert(QString prefix)
+{
+    Node *node = &m_root;
+    for(int i = 0;i < prefix.size();i++)
+    {
+        Node *child = node->m_children.value(prefix[i], NULL);
+        if(child == NULL)
+        {
+            child = new Node;
+            node->m_children[prefix[i]] = child;
+        }
+        node = child;
+    }
+    node->m_isEnd = true;
+}
+
+
+/**
+ * @brief Checks if the string starts with any of the prefixes.
+ */
+bool PrefixTrie::containsPrefixOf(QString str) const
+{
+    const Node *node = &m_root;
+    if(node->m_isEnd)
+        return true;
+    for(int i = 0;i < str.size();i++)
+    {
+        node = node->m_children.value(str[i], NULL);
+        if(node == NULL)
+            return false;
+        if(node->m_isEnd)
+            return true;
+    }
+    return false;
+}
+
+
+/**
+ *-------------------------------------------------------------
+ *
+ *
+ *
+ *
+ *-------------------------------------------------------------
+ */
+
+SourceFileChecker::SourceFileChecker()
+    : m_quit(false)
+    ,m_generation(0)
+{
+}
+
+SourceFileChecker::~SourceFileChecker()
+{
+}
+
+
+void SourceFileChecker::requestQuit()
+{
+    QMutexLocker locker(&m_mutex);
+    m_quit = true;
+    m_wait.wakeAll();
+}
+
+
+/**
+ * @brief Starts to check a new list of files. All jobs of older generations are cancelled.
+ */
+void SourceFileChecker::startJob(int generation, QStringList nameList, QStringList fullNameList, QStringList ignoreDirs)
+{
+    QMutexLocker locker(&m_mutex);
+    Job job;
+    job.m_generation = generation;
+    job.m_isUpdate = false;
+    job.m_nameList = nameList;
+    job.m_fullNameList = fullNameList;
+    job.m_ignoreDirs = ignoreDirs;
+    m_jobs.clear();
+    m_jobs.append(job);
+    m_generation = generation;
+    m_wait.wakeAll();
+}
+
+
+/**
+ * @brief Queues a check of files that has been added to (or removed from) the current list.
+ * @param removedList   Files to remove. They are passed on unchecked to keep the order of the updates.
+ */
+void SourceFileChecker::queueUpdate(int generation, QStringList nameList, QStringList fullNameList,
+                                QStringList removedList, QStringList ignoreDirs)
+{
+    QMutexLocker locker(&m_mutex);
+    Job job;
+    job.m_generation = generation;
+    job.m_isUpdate = true;
+    job.m_nameList = nameList;
+    job.m_fullNameList = fullNameList;
+    job.m_removedList = removedList;
+    job.m_ignoreDirs = ignoreDirs;
+    m_jobs.append(job);
+    m_wait.wakeAll();
+}
+
+
+bool SourceFileChecker::isCancelled(int generation)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_quit || m_generation != generation;
+}
+
+
+void SourceFileChecker::run()
+{
+    m_mutex.lock();
+    while(m_quit == false)
+    {
+        if(m_jobs.isEmpty())
+            m_wait.wait(&m_mutex);
+        else
+        {
+            Job job = m_jobs.takeFirst();
+            m_mutex.unlock();
+
+            process(job);
+
+            m_mutex.lock();
+        }
+    }
+    m_mutex.unlock();
+}
+
+
+void SourceFileChecker::process(const Job &job)
+{
+    PrefixTrie ignoreTrie;
+    for(int j = 0;j < job.m_ignoreDirs.size();j++)
+    {
+        if(!job.m_ignoreDirs[j].isEmpty())
+            ignoreTrie.insert(job.m_ignoreDirs[j]);
+    }
+
+    QStringList nameList;
+    QStringList fullNameList;
+    for(int i = 0;i < job.m_fullNameList.size();i++)
+    {
+        if((i % 1000) == 0 && isCancelled(job.m_generation))
+            return;
+
+        const QString &fullName = job.m_fullNameList[i];
+
+        // Ignore directory?
+        if(ignoreTrie.containsPrefixOf(fullName))
+            continue;
+
+        // File exist?
+        if(!QFileInfo::exists(fullName))
+        {
+            debugMsg("File '%s' does not exist", qPrintable(fullName));
+            continue;
+        }
+
+        nameList.append(job.m_nameList[i]);
+        fullNameList.append(fullName);
+    }
+
+    if(!isCancelled(job.m_generation))
+        emit onCheckDone(job.m_generation, nameList, fullNameList, job.m_removedList, job.m_isUpdate);
+}
+
+
+/**
+ *-------------------------------------------------------------
+ *
+ *
+ *
+ *
+ *-------------------------------------------------------------
+ */
+
+SourceTreeModel::SourceTreeModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+    m_root = new Node(NULL, "", "");
+}
+
+SourceTreeModel::~SourceTreeModel()
+{
+    delete m_root;
+}
+
+
+/**
+ * @brief Sort order of the items in the tree.
+ */
+bool SourceTreeModel::nodeLessThan(const Node *a, const Node *b)
+{
+    return a->m_name < b->m_name;
+}
+
+
+void SourceTreeModel::setIcons(QIcon folderIcon, QIcon fileIcon)
+{
+    m_folderIcon = folderIcon;
+    m_fileIcon = fileIcon;
+}
+
+
+/**
+ * @brief Splits a directory path into the names of the directories.
+ *
+ * "../" removes the previous directory (if any). Eg: "/a/b/../c" => {"a","c"}.
+ */
+QStringList SourceTreeModel::splitPath(QString folderPath)
+{
+    QStringList dirList;
+    QStringList nameList = folderPath.split('/');
+    for(int i = 0;i < nameList.size();i++)
+    {
+        const QString &name = nameList[i];
+        if(name == ".." && !dirList.isEmpty())
+            dirList.removeLast();
+        else if(!name.isEmpty())
+            dirList.append(name);
+    }
+    return dirList;
+}
+
+
+/**
+ * @brief Returns a child node with a specific name. The node is created if it does not exist.
+ *
+ * Used while building the tree. The model is not notified.
+ */
+SourceTreeModel::Node *SourceTreeModel::getChild(Node *parent, QString name)
+{
+    Node *child = parent->m_childByName.value(name, NULL);
+    if(child == NULL)
+    {
+        child = new Node(parent, name, name);
+        parent->m_children.append(child);
+        parent->m_childByName[name] = child;
+    }
+    return child;
+}
+
+
+/**
+ * @brief Inserts a new node at its sorted position in the parent.
+ */
+SourceTreeModel::Node *SourceTreeModel::insertChild(Node *parent, QString key, QString name)
+{
+    Node *child = new Node(parent, key, name);
+    int row = std::upper_bound(parent->m_children.begin(), parent->m_children.end(), child, nodeLessThan) - parent->m_children.begin();
+
+    QModelIndex parentIndex;
+    if(parent != m_root)
+        parentIndex = createIndex(parent->m_row, 0, parent);
+    beginInsertRows(parentIndex, row, row);
+    parent->m_children.insert(row, child);
+    parent->m_childByName[key] = child;
+    for(int r = row;r < parent->m_children.size();r++)
+        parent->m_children[r]->m_row = r;
+    endInsertRows();
+
+    return child;
+}
+
+
+/**
+ * @brief Removes a node (and all nodes below it) from the tree.
+ */
+void SourceTreeModel::removeNode(Node *node)
+{
+    Node *parent = node->m_parent;
+    int row = node->m_row;
+
+    QModelIndex parentIndex;
+    if(parent != m_root)
+        parentIndex = createIndex(parent->m_row, 0, parent);
+    beginRemoveRows(parentIndex, row, row);
+    parent->m_children.remove(row);
+    parent->m_childByName.remove(node->m_key);
+    for(int r = row;r < parent->m_children.size();r++)
+        parent->m_children[r]->m_row = r;
+    endRemoveRows();
+
+    delete node;
+}
+
+
+/**
+ * @brief Finds the node of a directory in the tree.
+ * @param create       Creates the directories that does not exist.
+ * @param expandList   Receives the created directories that should be expanded.
+ * @return The node or NULL if not found (or if the path goes through a wrapped directory).
+ */
+SourceTreeModel::Node *SourceTreeModel::findDir(QStringList dirList, bool create, QVector<Node*> *expandList)
+{
+    Node *node = m_root;
+    for(int i = 0;i < dirList.size();i++)
+    {
+        QString name = dirList[i];
+        Node *child = node->m_childByName.value(name, NULL);
+        if(child == NULL)
+        {
+            if(!create)
+                return NULL;
+            child = insertChild(node, name, (node == m_root) ? ("/" + name) : name);
+            if(name != "usr" && name != "opt")
+                expandList->append(child);
+        }
+        else if(child->isFile())
+            return NULL;
+
+        // The path must contain all the directories wrapped into the node
+        for(int j = 0;j < child->m_wrapList.size();j++)
+        {
+            if(i+1 >= dirList.size() || dirList[i+1] != child->m_wrapList[j])
+                return NULL;
+            i++;
+        }
+        node = child;
+    }
+    return node;
+}
+
+
+/**
+ * @brief Builds the tree again from the list of files.
+ * @param expandList   Receives the directories that should be expanded.
+ */
+void SourceTreeModel::rebuild(QModelIndexList *expandList)
+{
+    beginResetModel();
+
+    delete m_root;
+    m_root = new Node(NULL, "", "");
+
+    QSet<QString>::const_iterator iter;
+    for(iter = m_fileSet.constBegin();iter != m_fileSet.constEnd();++iter)
+    {
+        const QString &fullName = *iter;
+
+        // Get parent path
+        QString folderPath;
+        QString filename;
+        dividePath(fullName, &filename, &folderPath);
+        QStringList dirList = splitPath(simplifyPath(folderPath));
+
+        Node *parentNode = m_root;
+        for(int i = 0;i < dirList.size();i++)
+        {
+            if(parentNode != m_root && parentNode->m_name != "usr" && parentNode->m_name != "opt")
+                parentNode->m_isExpanded = true;
+            parentNode = getChild(parentNode, dirList[i]);
+        }
+
+        Node *fileNode = getChild(parentNode, filename);
+        if(fileNode->m_fullName.isEmpty() && fileNode->m_children.isEmpty())
+            fileNode->m_fullName = fullName;
+        if(parentNode != m_root)
+            parentNode->m_isExpanded = true;
+    }
+
+    wrapTree();
+
+    sortNode(m_root);
+
+    endResetModel();
+
+    expandList->clear();
+    getExpandedList(m_root, expandList);
+}
+
+
+/**
+ * @brief Try to shrink the tree by removing dirs in the tree. Eg: "/usr/include/bits" => "/usr...bits".
+ */
+void SourceTreeModel::wrapTree()
+{
+    for(int u = 0;u < m_root->m_children.size();u++)
+    {
+        Node *rootNode = m_root->m_children[u];
+        if(rootNode->isFile())
+            continue;
+
+        if(rootNode->m_name != "usr")
+            rootNode->m_isExpanded = true;
+
+        QString newName =  "/" + rootNode->m_name;
+        while(rootNode->m_children.size() == 1 && !rootNode->m_children[0]->m_children.isEmpty())
+        {
+            Node *childNode = rootNode->m_children[0];
+            newName += "/" + childNode->m_name;
+            rootNode->m_wrapList.append(childNode->m_name);
+
+            // Move the grandchildren to the root node
+            rootNode->m_children = childNode->m_children;
+            rootNode->m_childByName = childNode->m_childByName;
+            for(int i = 0;i < rootNode->m_children.size();i++)
+                rootNode->m_children[i]->m_parent = rootNode;
+            childNode->m_children.clear();
+            delete childNode;
+        }
+        rootNode->m_name = newName;
+    }
+}
+
+
+/**
+ * @brief Sorts the children of a node (and all the nodes below it).
+ */
+void SourceTreeModel::sortNode(Node *node)
+{
+    std::stable_sort(node->m_children.begin(), node->m_children.end(), nodeLessThan);
+
+    for(int i = 0;i < node->m_children.size();i++)
+    {
+        Node *child = node->m_children[i];
+        child->m_row = i;
+        sortNode(child);
+    }
+}
+
+
+/**
+ * @brief Replaces all the files in the tree.
+ */
+void SourceTreeModel::setFiles(QStringList fullNameList)
+{
+    m_fileSet.clear();
+    for(int i = 0;i < fullNameList.size();i++)
+        m_fileSet.insert(fullNameList[i]);
+
+    QModelIndexList expandList;
+    rebuild(&expandList);
+}
+
+
+/**
+ * @brief Adds files to the tree.
+ *
+ * The files are inserted at their sorted position. The tree is only built
+ * again if a file is located inside a wrapped directory (Eg: "/usr/include").
+ * @param expandList   Receives the directories that should be expanded.
+ */
+void SourceTreeModel::addFiles(QStringList fullNameList, QModelIndexList *expandList)
+{
+    bool needRebuild = false;
+    QVector<Node*> newDirList;
+    for(int i = 0;i < fullNameList.size();i++)
+    {
+        const QString &fullName = fullNameList[i];
+        if(m_fileSet.contains(fullName))
+            continue;
+        m_fileSet.insert(fullName);
+        if(needRebuild)
+            continue;
+
+        QString folderPath;
+        QString filename;
+        dividePath(fullName, &filename, &folderPath);
+        Node *parentNode = findDir(splitPath(simplifyPath(folderPath)), true, &newDirList);
+        if(parentNode == NULL)
+            needRebuild = true;
+        else if(!parentNode->m_childByName.contains(filename))
+        {
+            Node *fileNode = insertChild(parentNode, filename, filename);
+            fileNode->m_fullName = fullName;
+        }
+    }
+
+    if(needRebuild)
+        rebuild(expandList);
+    else
+    {
+        // The rows are not known until all nodes has been inserted
+        for(int i = 0;i < newDirList.size();i++)
+            expandList->append(createIndex(newDirList[i]->m_row, 0, newDirList[i]));
+    }
+}
+
+
+/**
+ * @brief Removes files from the tree. Directories that becomes empty are also removed.
+ * @param expandList   Receives the directories that should be expanded if the tree had to be built again.
+ */
+void SourceTreeModel::removeFiles(QStringList fullNameList, QModelIndexList *expandList)
+{
+    bool needRebuild = false;
+    for(int i = 0;i < fullNameList.size();i++)
+    {
+        const QString &fullName = fullNameList[i];
+        if(!m_fileSet.remove(fullName) || needRebuild)
+            continue;
+
+        QString folderPath;
+        QString filename;
+        dividePath(fullName, &filename, &folderPath);
+        Node *node = findDir(splitPath(simplifyPath(folderPath)), false, NULL);
+        if(node)
+            node = node->m_childByName.value(filename, NULL);
+        if(node == NULL || node->m_fullName != fullName)
+        {
+            needRebuild = true;
+            continue;
+        }
+
+        // Remove the file and the directories that became empty
+        do
+        {
+            Node *parent = node->m_parent;
+            removeNode(node);
+            node = parent;
+        } while(node != m_root && node->m_children.isEmpty());
+    }
+
+    if(needRebuild)
+        rebuild(expandList);
+}
+
+
+/**
+ * @brief Returns the path of a file in the tree.
+ * @return The path or an empty string if the index is a directory.
+ */
+QString SourceTreeModel::getFilePath(const QModelIndex &index) const
+{
+    Node *node = getNode(index);
+    if(node == NULL)
+        return "";
+    return node->m_fullName;
+}
+
+
+void SourceTreeModel::getExpandedList(Node *node, QModelIndexList *list) const
+{
+    for(int i = 0;i < node->m_children.size();i++)
+    {
+        Node *child = node->m_children[i];
+        if(child->m_isExpanded)
+        {
+            list->append(createIndex(child->m_row, 0, child));
+            getExpandedList(child, list);
+        }
+    }
+}
+
+
+/**
+ * @brief Returns the directories that should be expanded in the view.
+ */
+QModelIndexList SourceTreeModel::getExpandedList() const
+{
+    QModelIndexList list;
+    getExpandedList(m_root, &list);
+    return list;
+}
+
+
+SourceTreeModel::Node *SourceTreeModel::getNode(const QModelIndex &index) const
+{
+    if(!index.isValid())
+        return NULL;
+    return static_cast<Node*>(index.internalPointer());
+}
+
+
+QModelIndex SourceTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    Node *parentNode = parent.isValid() ? getNode(parent) : m_root;
+    if(row < 0 || row >= parentNode->m_children.size() || column != 0)
+        return QModelIndex();
+    return createIndex(row, column, parentNode->m_children[row]);
+}
+
+
+QModelIndex SourceTreeModel::parent(const QModelIndex &index) const
+{
+    Node *node = getNode(index);
+    if(node == NULL || node->m_parent == m_root || node->m_parent == NULL)
+        return QModelIndex();
+    return createIndex(node->m_parent->m_row, 0, node->m_parent);
+}
+
+
+int SourceTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.column() > 0)
+        return 0;
+    Node *parentNode = parent.isValid() ? getNode(parent) : m_root;
+    return parentNode->m_children.size();
+}
+
+
+int SourceTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+
+QVariant SourceTreeModel::data(const QModelIndex &index, int role) const
+{
+    Node *node = getNode(index);
+    if(node == NULL)
+        return QVariant();
+
+    if(role == Qt::DisplayRole)
+        return node->m_name;
+    else if(role == Qt::DecorationRole)
+        return node->isFile() ? m_fileIcon : m_folderIcon;
+    else if(role == Qt::UserRole)
+        return node->m_fullName;
+    return QVariant();
+}
+
+
+QVariant SourceTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation == Qt::Horizontal && role == Qt::DisplayRole && section == 0)
+        return QString("Name");
+    return QVariant();
+}
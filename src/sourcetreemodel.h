@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2014-2020 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__SOURCETREEMODEL_H
+#define FILE__SOURCETREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QIcon>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+
+/**
+ * @brief A set of prefixes (Eg: "/usr/include") that a path can be matched against.
+ */
+class PrefixTrie
+{
+public:
+    PrefixTrie();
+    ~PrefixTrie();
+
+    void insert(QString prefix);
+    bool containsPrefixOf(QString str) const;
+
+private:
+    Q_DISABLE_COPY(PrefixTrie)
+
+    class Node
+    {
+    public:
+        Node() : m_isEnd(false) {};
+        ~Node() { qDeleteAll(m_children); };
+
+        bool m_isEnd; //!< True if a prefix ends at this node.
+        QHash<QChar, Node*> m_children;
+    };
+    Node m_root;
+};
+
+
+/**
+ * @brief Thread that removes source files that does not exist or are
+ * located in ignored directories.
+ *
+ * The jobs are processed in the order they are queued. Starting a new
+ * generation cancels all jobs of the older generations.
+ */
+class SourceFileChecker : public QThread
+{
+    Q_OBJECT
+
+public:
+    SourceFileChecker();
+    virtual ~SourceFileChecker();
+
+    void run();
+    void requestQuit();
+
+    void startJob(int generation, QStringList nameList, QStringList fullNameList, QStringList ignoreDirs);
+    void queueUpdate(int generation, QStringList nameList, QStringList fullNameList,
+                    QStringList removedList, QStringList ignoreDirs);
+
+signals:
+    void onCheckDone(int generation, QStringList nameList, QStringList fullNameList,
+                    QStringList removedList, bool isUpdate);
+
+private:
+    struct Job
+    {
+        int m_generation;
+        bool m_isUpdate; //!< True if the files should be added to the current list
+        QStringList m_nameList;
+        QStringList m_fullNameList;
+        QStringList m_removedList;
+        QStringList m_ignoreDirs;
+    };
+    void process(const Job &job);
+    bool isCancelled(int generation);
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_wait;
+    bool m_quit;
+    QList<Job> m_jobs;
+    int m_generation; //!< Generation of the latest job
+};
+
+
+/**
+ * @brief Model for the tree of source files.
+ *
+ * Each directory keeps its children in a hash so that inserting a file
+ * does not need to search through its siblings.
+ */
+class SourceTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    SourceTreeModel(QObject *parent = NULL);
+    virtual ~SourceTreeModel();
+
+    void setIcons(QIcon folderIcon, QIcon fileIcon);
+    void setFiles(QStringList fullNameList);
+    void addFiles(QStringList fullNameList, QModelIndexList *expandList);
+    void removeFiles(QStringList fullNameList, QModelIndexList *expandList);
+
+    QString getFilePath(const QModelIndex &index) const;
+    QModelIndexList getExpandedList() const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &index) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+private:
+    class Node
+    {
+    public:
+        Node(Node *parent, QString key, QString name)
+            : m_parent(parent), m_key(key), m_name(name), m_isExpanded(false), m_row(0) {};
+        ~Node() { qDeleteAll(m_children); };
+
+        bool isFile() const { return !m_fullName.isEmpty(); };
+
+        Node *m_parent;
+        QString m_key; //!< The name in the parent's hash.
+        QString m_name; //!< The name to display (Eg: "/usr/include" for a wrapped directory).
+        QStringList m_wrapList; //!< Directories that has been wrapped into this node.
+        QString m_fullName; //!< The path of the file (empty for directories).
+        bool m_isExpanded;
+        int m_row; //!< Index in the parent's child list.
+        QVector<Node*> m_children;
+        QHash<QString, Node*> m_childByName;
+    };
+
+    static QStringList splitPath(QString folderPath);
+    Node *getChild(Node *parent, QString name);
+    Node *insertChild(Node *parent, QString key, QString name);
+    void removeNode(Node *node);
+    Node *findDir(QStringList dirList, bool create, QVector<Node*> *expandList);
+    void rebuild(QModelIndexList *expandList);
+    void wrapTree();
+    void sortNode(Node *node);
+    static bool nodeLessThan(const Node *a, const Node *b);
+    void getExpandedList(Node *node, QModelIndexList *list) const;
+    Node *getNode(const QModelIndex &index) const;
+
+private:
+    Node *m_root;
+    QSet<QString> m_fileSet; //!< All the files in the tree.
+    QIcon m_folderIcon;
+    QIcon m_fileIcon;
+};
+
+
+#endif // FILE__SOURCETREEMODEL_H
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2014-2020 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "stackframemodel.h"
+
+#include <algorithm>
+
+#include "config.h"
+
+
+StackFrameModel::StackFrameModel(QObject *parent)
+    : QAbstractListModel(parent)
+    ,m_depth(0)
+{
+    m_fetchTimer.setSingleShot(true);
+    m_fetchTimer.setInterval(0);
+    connect(&m_fetchTimer, SIGNAL(timeout()), SLOT(onFetchTimeout()));
+}
+
+StackFrameModel::~StackFrameModel()
+{
+}
+
+
+/**
+ * @brief Sets the number of frames in the stack and forgets the fetched frames.
+ */
+void StackFrameModel::setDepth(int depth)
+{
+    beginResetModel();
+    m_depth = depth;
+    m_frames.clear();
+    m_pendingChunks.clear();
+    m_requestedChunks.clear();
+    endResetModel();
+}
+
+
+/**
+ * @brief Sets fetched frames.
+ * @param lowFrame   The index of the first frame in frameList.
+ * @param frameList  The frames (innermost frame first).
+ */
+void StackFrameModel::setFrames(int lowFrame, QList<StackFrameEntry> frameList)
+{
+    if(frameList.isEmpty())
+        return;
+    for(int i = 0;i < frameList.size();i++)
+        m_frames[lowFrame+i] = frameList[i];
+
+    QModelIndex first = findFrame(lowFrame+frameList.size()-1);
+    QModelIndex last = findFrame(lowFrame);
+    if(first.isValid() && last.isValid())
+        emit dataChanged(first, last);
+}
+
+
+void StackFrameModel::clear()
+{
+    setDepth(0);
+}
+
+
+/**
+ * @brief Returns the frame index (0 being the innermost frame) of a row.
+ * @return The index or -1 if the index is not valid.
+ */
+int StackFrameModel::getFrameIdx(const QModelIndex &index) const
+{
+    if(!index.isValid() || index.row() >= m_depth)
+        return -1;
+    return m_depth-index.row()-1;
+}
+
+
+QModelIndex StackFrameModel::findFrame(int frameIdx) const
+{
+    if(frameIdx < 0 || frameIdx >= m_depth)
+        return QModelIndex();
+    return index(m_depth-frameIdx-1, 0);
+}
+
+
+/**
+ * @brief Returns a frame.
+ * @return false if the frame has not been fetched yet.
+ */
+bool StackFrameModel::getFrame(int frameIdx, StackFrameEntry *entry) const
+{
+    QHash<int, StackFrameEntry>::const_iterator iter = m_frames.find(frameIdx);
+    if(iter == m_frames.constEnd())
+        return false;
+    *entry = iter.value();
+    return true;
+}
+
+
+/**
+ * @brief Requests the chunk of frames that a frame belongs to.
+ */
+void StackFrameModel::requestFrame(int frameIdx) const
+{
+    int chunk = frameIdx / STACK_FRAME_FETCH_COUNT;
+    if(m_requestedChunks.contains(chunk))
+        return;
+    m_requestedChunks.insert(chunk);
+    m_pendingChunks.insert(chunk);
+    m_fetchTimer.start();
+}
+
+
+/**
+ * @brief Requests the pending chunks (one request per range of adjacent chunks).
+ */
+void StackFrameModel::onFetchTimeout()
+{
+    QList<int> chunkList = m_pendingChunks.values();
+    m_pendingChunks.clear();
+    std::sort(chunkList.begin(), chunkList.end());
+
+    int i = 0;
+    while(i < chunkList.size())
+    {
+        int firstChunk = chunkList[i];
+        int lastChunk = firstChunk;
+        for(i = i+1;i < chunkList.size() && chunkList[i] == lastChunk+1;i++)
+            lastChunk++;
+
+        int lowFrame = firstChunk*STACK_FRAME_FETCH_COUNT;
+        int highFrame = std::min((lastChunk+1)*STACK_FRAME_FETCH_COUNT, m_depth)-1;
+        if(lowFrame <= highFrame)
+            emit framesRequested(lowFrame, highFrame);
+    }
+}
+
+
+int StackFrameModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid())
+        return 0;
+    return m_depth;
+}
+
+
+QVariant StackFrameModel::data(const QModelIndex &index, int role) const
+{
+    int frameIdx = getFrameIdx(index);
+    if(frameIdx == -1 || (role != Qt::DisplayRole && role != Qt::ToolTipRole))
+        return QVariant();
+
+    QHash<int, StackFrameEntry>::const_iterator iter = m_frames.find(frameIdx);
+    if(iter == m_frames.constEnd())
+    {
+        requestFrame(frameIdx);
+        return QString("...");
+    }
+
+    const StackFrameEntry &frame = iter.value();
+    if(role == Qt::ToolTipRole)
+    {
+        if(frame.m_sourcePath.isEmpty())
+            return QVariant();
+        return QString("%1:%2").arg(frame.m_sourcePath).arg(frame.m_line);
+    }
+    return frame.m_functionName;
+}
+
+
+QVariant StackFrameModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation != Qt::Horizontal || role != Qt::DisplayRole || section != 0)
+        return QVariant();
+    return QString("Name");
+}
+
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2014-2020 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__STACKFRAMEMODEL_H
+#define FILE__STACKFRAMEMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+
+#include "core.h"
+
+
+/**
+ * @brief Model for the stack of the current thread.
+ *
+ * The model has one row per frame (the outermost frame first) but only
+ * the frames that are shown are fetched. They are requested (with
+ * framesRequested()) in chunks of STACK_FRAME_FETCH_COUNT frames and
+ * the chunks that are requested at the same time are collected so that
+ * they can be fetched with one command.
+ */
+class StackFrameModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    StackFrameModel(QObject *parent = NULL);
+    virtual ~StackFrameModel();
+
+    void setDepth(int depth);
+    void setFrames(int lowFrame, QList<StackFrameEntry> frameList);
+    void clear();
+
+    int getFrameIdx(const QModelIndex &index) const;
+    QModelIndex findFrame(int frameIdx) const;
+    bool getFrame(int frameIdx, StackFrameEntry *entry) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+signals:
+    void framesRequested(int lowFrame, int highFrame);
+
+private slots:
+    void onFetchTimeout();
+
+private:
+    void requestFrame(int frameIdx) const;
+
+private:
+    int m_depth; //!< Number of frames in the stack.
+    QHash<int, StackFrameEntry> m_frames; //!< Frame index (0=innermost) => frame.
+
+    // (Frames are requested when they are painted, which is done by the const data())
+    mutable QSet<int> m_pendingChunks; //!< Chunks to request the frames for.
+    mutable QSet<int> m_requestedChunks; //!< Chunks that has been requested.
+    mutable QTimer m_fetchTimer;
+};
+
+
+#endif // FILE__STACKFRAMEMODEL_H
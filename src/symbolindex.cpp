@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2018 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "symbolindex.h"
+
+#include <QElapsedTimer>
+#include <QPair>
+#include <algorithm>
+
+#include "completionindex.h"
+
+
+SymbolIndex::SymbolIndex()
+    : m_revision(0)
+    ,m_sortedRevision(-1)
+{
+}
+
+SymbolIndex::~SymbolIndex()
+{
+}
+
+
+/**
+ * @brief Returns the name of the tag including the class (Eg: "Class::func").
+ */
+QString SymbolIndex::getQualifiedName(const Tag &tag)
+{
+    if(tag.m_className.isEmpty())
+        return tag.m_name;
+    return tag.m_className + "::" + tag.m_name;
+}
+
+
+/**
+ * @brief Sets (or replaces) the tags of a file.
+ */
+void SymbolIndex::setFileTags(QString filePath, const QList<Tag> &tagList)
+{
+    removeFile(filePath);
+
+    QVector<TagId> &fileIds = m_fileTags[filePath];
+    fileIds.reserve(tagList.size());
+    for(int i = 0;i < tagList.size();i++)
+    {
+        const Tag &tag = tagList[i];
+
+        TagId id;
+        if(m_freeIds.isEmpty())
+        {
+            id = m_tags.size();
+            m_tags.append(tag);
+        }
+        else
+        {
+            id = m_freeIds.takeLast();
+            m_tags[id] = tag;
+        }
+
+        fileIds.append(id);
+        m_byName[tag.m_name].append(id);
+        m_byQualifiedName[getQualifiedName(tag)].append(id);
+        if(!tag.m_className.isEmpty())
+            m_byClass[tag.m_className].append(id);
+    }
+    m_revision++;
+}
+
+
+/**
+ * @brief Removes a tag id from a hash entry (and the entry if it gets empty).
+ */
+static void removeId(QHash<QString, QVector<SymbolIndex::TagId> > *hash, QString key, SymbolIndex::TagId id)
+{
+    QHash<QString, QVector<SymbolIndex::TagId> >::iterator it = hash->find(key);
+    if(it == hash->end())
+        return;
+    it.value().removeOne(id);
+    if(it.value().isEmpty())
+        hash->erase(it);
+}
+
+
+/**
+ * @brief Removes all tags of a file.
+ */
+void SymbolIndex::removeFile(QString filePath)
+{
+    if(!m_fileTags.contains(filePath))
+        return;
+
+    QVector<TagId> fileIds = m_fileTags.take(filePath);
+    for(int i = 0;i < fileIds.size();i++)
+    {
+        TagId id = fileIds[i];
+        Tag &tag = m_tags[id];
+
+        removeId(&m_byName, tag.m_name, id);
+        removeId(&m_byQualifiedName, getQualifiedName(tag), id);
+        if(!tag.m_className.isEmpty())
+            removeId(&m_byClass, tag.m_className, id);
+
+        tag = Tag();
+        m_freeIds.append(id);
+    }
+    m_revision++;
+}
+
+
+void SymbolIndex::clear()
+{
+    m_tags.clear();
+    m_freeIds.clear();
+    m_fileTags.clear();
+    m_byName.clear();
+    m_byQualifiedName.clear();
+    m_byClass.clear();
+    m_revision++;
+}
+
+
+/**
+ * @brief Returns all tags with a specific name regardless of the class.
+ * @param name     The name (Eg: "myFunc").
+ */
+QVector<SymbolIndex::TagId> SymbolIndex::lookupName(QString name) const
+{
+    return m_byName.value(name);
+}
+
+
+/**
+ * @brief Returns all tags with a specific class and name.
+ * @param name     The name including the class (Eg: "Class::myFunc" or "main").
+ */
+QVector<SymbolIndex::TagId> SymbolIndex::lookupQualifiedName(QString name) const
+{
+    return m_byQualifiedName.value(name);
+}
+
+
+/**
+ * @brief Sorts all tags by name (if any tags has changed since the last time).
+ */
+void SymbolIndex::updateSortedList()
+{
+    if(m_sortedRevision == m_revision)
+        return;
+    m_sortedRevision = m_revision;
+
+    QVector<QPair<QString, TagId> > pairList;
+    pairList.reserve(m_tags.size());
+    foreach(const QVector<TagId> &fileIds, m_fileTags)
+    {
+        for(int i = 0;i < fileIds.size();i++)
+            pairList.append(qMakePair(m_tags[fileIds[i]].m_name.toLower(), fileIds[i]));
+    }
+    std::sort(pairList.begin(), pairList.end());
+
+    m_sortedIds.clear();
+    m_sortedNames.clear();
+    m_sortedQualifiedNames.clear();
+    m_sortedIds.reserve(pairList.size());
+    for(int i = 0;i < pairList.size();i++)
+    {
+        TagId id = pairList[i].second;
+        m_sortedIds.append(id);
+        m_sortedNames.append(pairList[i].first);
+        m_sortedQualifiedNames.append(getQualifiedName(m_tags[id]));
+    }
+}
+
+
+/**
+ * @brief Searches for tags (case insensitive).
+ *
+ * SEARCH_PREFIX matches the start of the name of the tag ("myFu" => "Class::myFunc").
+ * SEARCH_SUBSTRING and SEARCH_FUZZY matches the name including the class.
+ * @param timeBudgetMs    Stop searching after this time (-1 for no limit).
+ * @return The found tags. Sorted by name except for SEARCH_FUZZY which are sorted by relevance.
+ */
+QVector<SymbolIndex::TagId> SymbolIndex::search(QString pattern, SearchMode mode, int timeBudgetMs)
+{
+    QVector<TagId> result;
+    QElapsedTimer timer;
+    timer.start();
+
+    updateSortedList();
+
+    pattern = pattern.toLower();
+    if(pattern.isEmpty())
+        return m_sortedIds;
+
+    if(mode == SEARCH_PREFIX)
+    {
+        QStringList::const_iterator startIt = std::lower_bound(m_sortedNames.begin(), m_sortedNames.end(), pattern);
+        QStringList::const_iterator endIt = std::lower_bound(startIt, m_sortedNames.end(), pattern + QChar(0xffff));
+        int startIdx = startIt - m_sortedNames.begin();
+        int endIdx = endIt - m_sortedNames.begin();
+        result = m_sortedIds.mid(startIdx, endIdx-startIdx);
+    }
+    else if(mode == SEARCH_SUBSTRING)
+    {
+        for(int i = 0;i < m_sortedIds.size();i++)
+        {
+            if(timeBudgetMs >= 0 && (i & 0xff) == 0 && timer.elapsed() > timeBudgetMs)
+                break;
+            if(m_sortedQualifiedNames[i].contains(pattern, Qt::CaseInsensitive))
+                result.append(m_sortedIds[i]);
+        }
+    }
+    else
+    {
+        QVector<QPair<int, int> > scoreList; // (-score, idx)
+        for(int i = 0;i < m_sortedIds.size();i++)
+        {
+            if(timeBudgetMs >= 0 && (i & 0xff) == 0 && timer.elapsed() > timeBudgetMs)
+                break;
+            int score = CompletionIndex::fuzzyScore(pattern, m_sortedQualifiedNames[i], false);
+            if(score >= 0)
+                scoreList.append(qMakePair(-score, i));
+        }
+        std::sort(scoreList.begin(), scoreList.end());
+        result.reserve(scoreList.size());
+        for(int i = 0;i < scoreList.size();i++)
+            result.append(m_sortedIds[scoreList[i].second]);
+    }
+    return result;
+}
+
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2018 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__SYMBOLINDEX_H
+#define FILE__SYMBOLINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include <QHash>
+
+#include "tagscanner.h"
+
+
+/**
+ * @brief Index of the tags in all scanned files.
+ *
+ * Each tag is identified by a TagId. The ids of a file are released
+ * when the file is rescanned or removed.
+ */
+class SymbolIndex
+{
+public:
+    typedef int TagId;
+
+    enum SearchMode
+    {
+        SEARCH_SUBSTRING,
+        SEARCH_PREFIX,
+        SEARCH_FUZZY
+    };
+
+    SymbolIndex();
+    virtual ~SymbolIndex();
+
+    void setFileTags(QString filePath, const QList<Tag> &tagList);
+    void removeFile(QString filePath);
+    void clear();
+
+    const Tag &getTag(TagId id) const { return m_tags[id]; };
+    QVector<TagId> getFileTags(QString filePath) const { return m_fileTags.value(filePath); };
+
+    QVector<TagId> lookupName(QString name) const;
+    QVector<TagId> lookupQualifiedName(QString name) const;
+
+    QStringList getClassList() const { return m_byClass.keys(); };
+    QVector<TagId> getClassMembers(QString className) const { return m_byClass.value(className); };
+
+    QStringList getFileList() const { return m_fileTags.keys(); };
+
+    int getRevision() const { return m_revision; };
+    
+    QVector<TagId> search(QString pattern, SearchMode mode, int timeBudgetMs = -1);
+
+    static QString getQualifiedName(const Tag &tag);
+
+private:
+    void updateSortedList();
+    
+private:
+    QVector<Tag> m_tags;
+    QVector<TagId> m_freeIds;
+    QHash<QString, QVector<TagId> > m_fileTags; //!< Filepath => ids
+    QHash<QString, QVector<TagId> > m_byName; //!< "func" => ids
+    QHash<QString, QVector<TagId> > m_byQualifiedName; //!< "Class::func" => ids
+    QHash<QString, QVector<TagId> > m_byClass; //!< "Class" => ids of the members
+    int m_revision; //!< Incremented on each change
+
+    // All tags sorted by name (built when needed)
+    QVector<TagId> m_sortedIds;
+    QStringList m_sortedNames; //!< Lowercase name of the tags in m_sortedIds
+    QStringList m_sortedQualifiedNames; //!< Qualified name of the tags in m_sortedIds
+    int m_sortedRevision;
+};
+
+
+#endif // FILE__SYMBOLINDEX_H
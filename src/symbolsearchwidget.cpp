@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2018 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "symbolsearchwidget.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHash>
+
+#include "config.h"
+#include "util.h"
+
+
+SymbolSearchModel::SymbolSearchModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+}
+
+SymbolSearchModel::~SymbolSearchModel()
+{
+}
+
+
+int SymbolSearchModel::addNode(int parentIdx, QString text, QString filePath, int lineNo)
+{
+    Node node;
+    node.m_parent = parentIdx;
+    node.m_text = text;
+    node.m_filePath = filePath;
+    node.m_lineNo = lineNo;
+
+    int nodeIdx = m_nodes.size();
+    if(parentIdx == -1)
+    {
+        node.m_row = m_topNodes.size();
+        m_topNodes.append(nodeIdx);
+    }
+    else
+    {
+        node.m_row = m_nodes[parentIdx].m_children.size();
+        m_nodes[parentIdx].m_children.append(nodeIdx);
+    }
+    m_nodes.append(node);
+    return nodeIdx;
+}
+
+
+/**
+ * @brief Sets the symbols to show.
+ *
+ * The symbols are grouped by kind (function/variable) and then by file.
+ */
+void SymbolSearchModel::setSymbols(const SymbolIndex &index, QVector<SymbolIndex::TagId> idList)
+{
+    beginResetModel();
+
+    m_nodes.clear();
+    m_topNodes.clear();
+
+    int kindNodeIdx[2] = {-1, -1};
+    QHash<QString, int> fileNodeIdx[2];
+    for(int i = 0;i < idList.size();i++)
+    {
+        const Tag &tag = index.getTag(idList[i]);
+        int kind = tag.isFunc() ? 0 : 1;
+
+        if(kindNodeIdx[kind] == -1)
+            kindNodeIdx[kind] = addNode(-1, kind == 0 ? "Functions" : "Variables", "", 0);
+
+        QString filePath = tag.getFilePath();
+        int fileIdx = fileNodeIdx[kind].value(filePath, -1);
+        if(fileIdx == -1)
+        {
+            fileIdx = addNode(kindNodeIdx[kind], getFilenamePart(filePath), filePath, 0);
+            fileNodeIdx[kind][filePath] = fileIdx;
+        }
+
+        addNode(fileIdx, tag.getLongName(), filePath, tag.getLineNo());
+    }
+
+    endResetModel();
+}
+
+
+/**
+ * @brief Returns the location of a symbol.
+ * @return false if the index is not a symbol.
+ */
+bool SymbolSearchModel::getLocation(const QModelIndex &index, QString *filePath, int *lineNo) const
+{
+    if(!index.isValid())
+        return false;
+    const Node &node = m_nodes[(int)index.internalId()];
+    if(node.m_lineNo == 0)
+        return false;
+    *filePath = node.m_filePath;
+    *lineNo = node.m_lineNo;
+    return true;
+}
+
+
+QModelIndex SymbolSearchModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if(!hasIndex(row, column, parent))
+        return QModelIndex();
+
+    int nodeIdx;
+    if(!parent.isValid())
+        nodeIdx = m_topNodes[row];
+    else
+        nodeIdx = m_nodes[(int)parent.internalId()].m_children[row];
+    return createIndex(row, column, quintptr(nodeIdx));
+}
+
+
+QModelIndex SymbolSearchModel::parent(const QModelIndex &index) const
+{
+    if(!index.isValid())
+        return QModelIndex();
+
+    int parentIdx = m_nodes[(int)index.internalId()].m_parent;
+    if(parentIdx == -1)
+        return QModelIndex();
+    return createIndex(m_nodes[parentIdx].m_row, 0, quintptr(parentIdx));
+}
+
+
+int SymbolSearchModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.column() > 0)
+        return 0;
+    if(!parent.isValid())
+        return m_topNodes.size();
+    return m_nodes[(int)parent.internalId()].m_children.size();
+}
+
+
+int SymbolSearchModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+
+QVariant SymbolSearchModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid())
+        return QVariant();
+
+    const Node &node = m_nodes[(int)index.internalId()];
+    if(role == Qt::DisplayRole)
+    {
+        if(index.column() == COLUMN_NAME)
+        {
+            if(node.m_parent == -1)
+                return QString("%1 (%2)").arg(node.m_text).arg(node.m_children.size());
+            return node.m_text;
+        }
+        else if(index.column() == COLUMN_LINE && node.m_lineNo > 0)
+            return node.m_lineNo;
+    }
+    else if(role == Qt::ToolTipRole)
+    {
+        if(!node.m_filePath.isEmpty())
+            return node.m_filePath;
+    }
+    return QVariant();
+}
+
+
+QVariant SymbolSearchModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation == Qt::Horizontal && role == Qt::DisplayRole)
+    {
+        if(section == COLUMN_NAME)
+            return QString("Name");
+        else if(section == COLUMN_LINE)
+            return QString("Line");
+    }
+    return QVariant();
+}
+
+
+/**
+ *-------------------------------------------------------------
+ */
+
+
+SymbolSearchWidget::SymbolSearchWidget(QWidget *parent)
+    : QWidget(parent)
+    ,m_mgr(NULL)
+    ,m_resultRevision(-1)
+    ,m_pageIdx(0)
+{
+    m_lineEdit.setPlaceholderText("Search symbol");
+    m_modeComboBox.addItem("Substring", (int)SymbolIndex::SEARCH_SUBSTRING);
+    m_modeComboBox.addItem("Prefix", (int)SymbolIndex::SEARCH_PREFIX);
+    m_modeComboBox.addItem("Fuzzy", (int)SymbolIndex::SEARCH_FUZZY);
+
+    m_treeView.setModel(&m_model);
+    m_treeView.setColumnWidth(SymbolSearchModel::COLUMN_NAME, 200);
+    m_treeView.setUniformRowHeights(true);
+
+    m_prevButton.setText("<");
+    m_nextButton.setText(">");
+    m_pageLabel.setAlignment(Qt::AlignCenter);
+
+    QHBoxLayout *searchLayout = new QHBoxLayout;
+    searchLayout->addWidget(&m_lineEdit);
+    searchLayout->addWidget(&m_modeComboBox);
+
+    QHBoxLayout *pageLayout = new QHBoxLayout;
+    pageLayout->addWidget(&m_prevButton);
+    pageLayout->addWidget(&m_pageLabel, 1);
+    pageLayout->addWidget(&m_nextButton);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(searchLayout);
+    layout->addWidget(&m_treeView);
+    layout->addLayout(pageLayout);
+
+    // Wait until the user has stopped typing before searching
+    m_searchTimer.setSingleShot(true);
+    m_searchTimer.setInterval(SYMBOL_SEARCH_DELAY);
+
+    connect(&m_lineEdit, SIGNAL(textEdited(const QString &)), SLOT(onSearchTextEdited(const QString &)));
+    connect(&m_lineEdit, SIGNAL(returnPressed()), SLOT(onSearch()));
+    connect(&m_searchTimer, SIGNAL(timeout()), SLOT(onSearch()));
+    connect(&m_modeComboBox, SIGNAL(currentIndexChanged(int)), SLOT(onModeChanged(int)));
+    connect(&m_prevButton, SIGNAL(clicked()), SLOT(onPrevPage()));
+    connect(&m_nextButton, SIGNAL(clicked()), SLOT(onNextPage()));
+    connect(&m_treeView, SIGNAL(clicked(const QModelIndex &)), SLOT(onItemActivated(const QModelIndex &)));
+    connect(&m_treeView, SIGNAL(activated(const QModelIndex &)), SLOT(onItemActivated(const QModelIndex &)));
+
+    showPage();
+}
+
+SymbolSearchWidget::~SymbolSearchWidget()
+{
+}
+
+
+void SymbolSearchWidget::setTagManager(TagManager *mgr)
+{
+    m_mgr = mgr;
+}
+
+
+/**
+ * @brief Redo the search (called when the tags has changed).
+ */
+void SymbolSearchWidget::refresh()
+{
+    m_searchTimer.stop();
+    search();
+    m_pageIdx = qMin(m_pageIdx, qMax(0, (m_result.size()-1) / SYMBOL_SEARCH_PAGE_SIZE));
+    showPage();
+}
+
+
+void SymbolSearchWidget::onSearchTextEdited(const QString &text)
+{
+    Q_UNUSED(text);
+    m_searchTimer.start();
+}
+
+
+void SymbolSearchWidget::onModeChanged(int idx)
+{
+    Q_UNUSED(idx);
+    onSearch();
+}
+
+
+void SymbolSearchWidget::onSearch()
+{
+    m_searchTimer.stop();
+
+    search();
+    m_pageIdx = 0;
+    showPage();
+}
+
+
+/**
+ * @brief Searches for the text in the line edit and stores the result in m_result.
+ */
+void SymbolSearchWidget::search()
+{
+    m_result.clear();
+    m_resultRevision = m_mgr ? m_mgr->getIndex().getRevision() : -1;
+
+    QString text = m_lineEdit.text().trimmed();
+    if(m_mgr && !text.isEmpty())
+    {
+        SymbolIndex::SearchMode mode = (SymbolIndex::SearchMode)m_modeComboBox.itemData(m_modeComboBox.currentIndex()).toInt();
+        m_result = m_mgr->searchSymbols(text, mode);
+    }
+}
+
+
+/**
+ * @brief Shows the symbols on the current page.
+ */
+void SymbolSearchWidget::showPage()
+{
+    // The ids are reused when files are rescanned or removed from the index
+    if(m_mgr && m_resultRevision != m_mgr->getIndex().getRevision())
+    {
+        search();
+        m_pageIdx = qMin(m_pageIdx, qMax(0, (m_result.size()-1) / SYMBOL_SEARCH_PAGE_SIZE));
+    }
+
+    int startIdx = m_pageIdx * SYMBOL_SEARCH_PAGE_SIZE;
+    QVector<SymbolIndex::TagId> pageList = m_result.mid(startIdx, SYMBOL_SEARCH_PAGE_SIZE);
+
+    if(m_mgr)
+        m_model.setSymbols(m_mgr->getIndex(), pageList);
+    m_treeView.expandAll();
+
+    if(m_result.isEmpty())
+        m_pageLabel.setText("No symbols");
+    else
+        m_pageLabel.setText(QString("%1-%2 of %3").arg(startIdx+1).arg(startIdx+pageList.size()).arg(m_result.size()));
+    m_prevButton.setEnabled(m_pageIdx > 0);
+    m_nextButton.setEnabled(startIdx+pageList.size() < m_result.size());
+}
+
+
+void SymbolSearchWidget::onPrevPage()
+{
+    if(m_pageIdx > 0)
+    {
+        m_pageIdx--;
+        showPage();
+    }
+}
+
+
+void SymbolSearchWidget::onNextPage()
+{
+    if((m_pageIdx+1) * SYMBOL_SEARCH_PAGE_SIZE < m_result.size())
+    {
+        m_pageIdx++;
+        showPage();
+    }
+}
+
+
+void SymbolSearchWidget::onItemActivated(const QModelIndex &index)
+{
+    QString filePath;
+    int lineNo;
+    if(m_model.getLocation(index, &filePath, &lineNo))
+        emit symbolActivated(filePath, lineNo);
+}
+
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2018 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__SYMBOLSEARCHWIDGET_H
+#define FILE__SYMBOLSEARCHWIDGET_H
+
+#include <QWidget>
+#include <QAbstractItemModel>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QTreeView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+#include <QVector>
+
+#include "tagmanager.h"
+
+
+/**
+ * @brief Model with the symbols on a page grouped by kind and file.
+ */
+class SymbolSearchModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum { COLUMN_NAME = 0, COLUMN_LINE, COLUMN_COUNT };
+
+    SymbolSearchModel(QObject *parent = NULL);
+    virtual ~SymbolSearchModel();
+
+    void setSymbols(const SymbolIndex &index, QVector<SymbolIndex::TagId> idList);
+
+    bool getLocation(const QModelIndex &index, QString *filePath, int *lineNo) const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &index) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+private:
+    struct Node
+    {
+        int m_parent; //!< Index of the parent node (-1 for top level nodes)
+        int m_row; //!< Row in the parent
+        QVector<int> m_children;
+        QString m_text;
+        QString m_filePath;
+        int m_lineNo; //!< 0 for group nodes
+    };
+    int addNode(int parentIdx, QString text, QString filePath, int lineNo);
+
+private:
+    QVector<Node> m_nodes;
+    QVector<int> m_topNodes;
+};
+
+
+/**
+ * @brief Panel to search for symbols in all scanned files.
+ */
+class SymbolSearchWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    SymbolSearchWidget(QWidget *parent = NULL);
+    virtual ~SymbolSearchWidget();
+
+    void setTagManager(TagManager *mgr);
+    void refresh();
+
+signals:
+    void symbolActivated(QString filePath, int lineNo);
+
+private slots:
+    void onSearchTextEdited(const QString &text);
+    void onSearch();
+    void onModeChanged(int idx);
+    void onPrevPage();
+    void onNextPage();
+    void onItemActivated(const QModelIndex &index);
+
+private:
+    void search();
+    void showPage();
+
+private:
+    TagManager *m_mgr;
+    QLineEdit m_lineEdit;
+    QComboBox m_modeComboBox;
+    QTreeView m_treeView;
+    QLabel m_pageLabel;
+    QPushButton m_prevButton;
+    QPushButton m_nextButton;
+    QTimer m_searchTimer;
+    SymbolSearchModel m_model;
+
+    QVector<SymbolIndex::TagId> m_result; //!< All found symbols
+    int m_resultRevision; //!< Revision of the index that m_result refers to
+    int m_pageIdx;
+};
+
+
+#endif // FILE__SYMBOLSEARCHWIDGET_H
@@ -0,0 +1,668 @@
+/*
+ * Copyright (C) 2018 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "taglistmodel.h"
+
+#include <QBrush>
+#include <QPair>
+#include <QSet>
+#include <algorithm>
+
+#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
+#include <QRegularExpression>
+#else  
+#include <QRegExp>
+#endif
+
+#include "util.h"
+#include "config.h"
+
+
+FilterWorker::FilterWorker()
+    : m_quit(false)
+    ,m_hasJob(false)
+    ,m_generation(0)
+{
+}
+
+FilterWorker::~FilterWorker()
+{
+}
+
+
+void FilterWorker::requestQuit()
+{
+    QMutexLocker locker(&m_mutex);
+    m_quit = true;
+    m_wait.wakeAll();
+}
+
+
+/**
+ * @brief Starts to match names against patterns. Any ongoing job is cancelled.
+ */
+void FilterWorker::startJob(int generation, QStringList nameList, QStringList patternList, QList<QBitArray> candidateList)
+{
+    QMutexLocker locker(&m_mutex);
+    m_job.m_generation = generation;
+    m_job.m_nameList = nameList;
+    m_job.m_patternList = patternList;
+    m_job.m_candidateList = candidateList;
+    m_generation = generation;
+    m_hasJob = true;
+    m_wait.wakeAll();
+}
+
+
+bool FilterWorker::isCancelled(int generation)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_quit || m_generation != generation;
+}
+
+
+void FilterWorker::run()
+{
+    m_mutex.lock();
+    while(m_quit == false)
+    {
+        if(!m_hasJob)
+            m_wait.wait(&m_mutex);
+        else
+        {
+            Job job = m_job;
+            m_hasJob = false;
+            m_job = Job();
+            m_mutex.unlock();
+
+            process(job);
+
+            m_mutex.lock();
+        }
+    }
+    m_mutex.unlock();
+}
+
+
+/**
+ * @brief Matches the names in chunks and reports the result of each chunk.
+ */
+void FilterWorker::process(const Job &job)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
+    QVector<QRegularExpression> rxList;
+    for(int i = 0;i < job.m_patternList.size();i++)
+        rxList.append(QRegularExpression(QRegularExpression::wildcardToRegularExpression(job.m_patternList[i])));
+#else
+    QVector<QRegExp> rxList;
+    for(int i = 0;i < job.m_patternList.size();i++)
+    {
+        QRegExp rx(job.m_patternList[i]);
+        rx.setPatternSyntax(QRegExp::Wildcard);
+        rxList.append(rx);
+    }
+#endif
+
+    const QStringList &nameList = job.m_nameList;
+    int startIdx = 0;
+    do
+    {
+        if(isCancelled(job.m_generation))
+            return;
+
+        int endIdx = qMin(nameList.size(), startIdx + TAG_FILTER_CHUNK_SIZE);
+        QList<QBitArray> matchList;
+        for(int i = 0;i < rxList.size();i++)
+        {
+            const QBitArray &candidates = job.m_candidateList[i];
+            QBitArray match(endIdx-startIdx);
+            for(int idx = startIdx;idx < endIdx;idx++)
+            {
+                if(!candidates.isEmpty() && !candidates.testBit(idx))
+                    continue;
+#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
+                if(rxList[i].match(nameList[idx]).hasMatch())
+                    match.setBit(idx-startIdx);
+#else
+                if(rxList[i].indexIn(nameList[idx]) != -1)
+                    match.setBit(idx-startIdx);
+#endif
+            }
+            matchList.append(match);
+        }
+
+        emit onChunkDone(job.m_generation, startIdx, matchList, endIdx == nameList.size());
+        startIdx = endIdx;
+    } while(startIdx < nameList.size());
+}
+
+
+/**
+ *-------------------------------------------------------------
+ */
+
+
+TagFilter::TagFilter()
+    : m_dirty(true)
+    ,m_generation(0)
+{
+    // Wait until the user has stopped typing
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(TAG_FILTER_DELAY);
+    connect(&m_timer, SIGNAL(timeout()), SLOT(start()));
+
+    connect(&m_worker, SIGNAL(onChunkDone(int, int, QList<QBitArray>, bool)), SLOT(onChunkDone(int, int, QList<QBitArray>, bool)));
+    m_worker.start();
+}
+
+TagFilter::~TagFilter()
+{
+    m_worker.requestQuit();
+    m_worker.wait();
+}
+
+
+/**
+ * @brief Sets the names to filter.
+ */
+void TagFilter::setNames(QStringList nameList)
+{
+    m_nameList = nameList;
+    m_cache.clear();
+    m_cacheOrder.clear();
+    m_pendingPatterns.clear();
+    m_dirty = true;
+}
+
+
+/**
+ * @brief Splits a filter text ("func;*Test") into patterns.
+ */
+QStringList TagFilter::parseFilterText(QString text)
+{
+    QStringList patternList;
+    QStringList list = text.split(";");
+    for(int i = 0;i < list.size();i++)
+    {
+        QString item = list[i].trimmed();
+        if(!item.isEmpty())
+            patternList.append(item);
+    }
+    return patternList;
+}
+
+
+/**
+ * @brief Sets the filter text. The filter is evaluated a while later.
+ */
+void TagFilter::setFilterText(QString text)
+{
+    m_filterText = text;
+    m_timer.start();
+}
+
+
+/**
+ * @brief Checks if everything matched by newPattern is also matched by oldPattern.
+ */
+bool TagFilter::isRefinement(QString oldPattern, QString newPattern)
+{
+    if(oldPattern.contains('[') || newPattern.contains('['))
+        return false;
+    if(!newPattern.startsWith(oldPattern))
+        return false;
+#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
+    // The patterns must match the whole name
+    return oldPattern.endsWith('*');
+#else
+    return true;
+#endif
+}
+
+
+/**
+ * @brief Returns the names a pattern needs to be matched against (empty for all).
+ */
+QBitArray TagFilter::getCandidates(QString pattern)
+{
+    for(int i = m_cacheOrder.size()-1;i >= 0;i--)
+    {
+        QString oldPattern = m_cacheOrder[i];
+        if(oldPattern != pattern && m_cache.contains(oldPattern) && isRefinement(oldPattern, pattern))
+            return m_cache[oldPattern];
+    }
+    return QBitArray();
+}
+
+
+/**
+ * @brief Starts to evaluate the filter.
+ */
+void TagFilter::start()
+{
+    m_timer.stop();
+
+    QStringList patternList = parseFilterText(m_filterText);
+    if(!m_dirty && patternList == m_patterns)
+        return;
+    m_dirty = false;
+    m_patterns = patternList;
+    m_generation++;
+
+    // Forget the result of a cancelled evaluation
+    for(int i = 0;i < m_pendingPatterns.size();i++)
+    {
+        m_cache.remove(m_pendingPatterns[i]);
+        m_cacheOrder.removeAll(m_pendingPatterns[i]);
+    }
+    m_pendingPatterns.clear();
+
+    emit filterReset();
+
+    // Find the patterns that has not been matched yet
+    QList<QBitArray> candidateList;
+    for(int i = 0;i < m_patterns.size();i++)
+    {
+        QString pattern = m_patterns[i];
+        m_cacheOrder.removeAll(pattern);
+        m_cacheOrder.append(pattern);
+        if(!m_cache.contains(pattern) && !m_pendingPatterns.contains(pattern))
+        {
+            candidateList.append(getCandidates(pattern));
+            m_pendingPatterns.append(pattern);
+        }
+    }
+
+    if(m_pendingPatterns.isEmpty())
+    {
+        acceptRows(0, m_nameList.size());
+        pruneCache();
+        emit filterDone();
+    }
+    else
+    {
+        for(int i = 0;i < m_pendingPatterns.size();i++)
+            m_cache[m_pendingPatterns[i]] = QBitArray(m_nameList.size());
+        m_worker.startJob(m_generation, m_nameList, m_pendingPatterns, candidateList);
+    }
+}
+
+
+/**
+ * @brief Called when the worker has matched a chunk of the names.
+ */
+void TagFilter::onChunkDone(int generation, int startIdx, QList<QBitArray> matchList, bool done)
+{
+    if(generation != m_generation)
+        return;
+
+    for(int i = 0;i < matchList.size();i++)
+    {
+        QBitArray &bits = m_cache[m_pendingPatterns[i]];
+        const QBitArray &match = matchList[i];
+        for(int j = 0;j < match.size();j++)
+        {
+            if(match.testBit(j))
+                bits.setBit(startIdx+j);
+        }
+    }
+
+    int endIdx = startIdx;
+    if(!matchList.isEmpty())
+        endIdx += matchList[0].size();
+    acceptRows(startIdx, endIdx);
+
+    if(done)
+    {
+        m_pendingPatterns.clear();
+        pruneCache();
+        emit filterDone();
+    }
+}
+
+
+/**
+ * @brief Reports the names in a range that matches all of the patterns.
+ */
+void TagFilter::acceptRows(int startIdx, int endIdx)
+{
+    QVector<const QBitArray*> bitsList;
+    for(int i = 0;i < m_patterns.size();i++)
+        bitsList.append(&m_cache[m_patterns[i]]);
+
+    QVector<int> rowList;
+    for(int idx = startIdx;idx < endIdx;idx++)
+    {
+        bool isMatch = true;
+        for(int i = 0;i < bitsList.size() && isMatch;i++)
+            isMatch = bitsList[i]->testBit(idx);
+        if(isMatch)
+            rowList.append(idx);
+    }
+    if(!rowList.isEmpty())
+        emit rowsAccepted(rowList);
+}
+
+
+/**
+ * @brief Removes the least recently used patterns from the cache.
+ */
+void TagFilter::pruneCache()
+{
+    while(m_cacheOrder.size() > TAG_FILTER_CACHE_SIZE)
+    {
+        QString pattern = m_cacheOrder.first();
+        if(m_patterns.contains(pattern))
+            break;
+        m_cacheOrder.removeFirst();
+        m_cache.remove(pattern);
+    }
+}
+
+
+/**
+ *-------------------------------------------------------------
+ */
+
+
+TagListModel::TagListModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+    connect(&m_filter, SIGNAL(filterReset()), SLOT(onFilterReset()));
+    connect(&m_filter, SIGNAL(rowsAccepted(QVector<int>)), SLOT(onRowsAccepted(QVector<int>)));
+    connect(&m_filter, SIGNAL(filterDone()), SIGNAL(filterDone()));
+}
+
+TagListModel::~TagListModel()
+{
+}
+
+
+static bool textLessThan(const QPair<QString, int> &a, const QPair<QString, int> &b)
+{
+    return a.first < b.first;
+}
+
+
+/**
+ * @brief Fills the model with all functions (sorted by name).
+ * @param fileList   The files to show the functions of (the source files of the program).
+ */
+void TagListModel::setFunctions(const SymbolIndex &index, QStringList fileList)
+{
+    QVector<Entry> list;
+    QStringList filterNameList;
+    QVector<QPair<QString, int> > sortList;
+
+    for(int k = 0;k < fileList.size();k++)
+    {
+        QVector<SymbolIndex::TagId> idList = index.getFileTags(fileList[k]);
+        for(int i = 0;i < idList.size();i++)
+        {
+            const Tag &tag = index.getTag(idList[i]);
+            if(!tag.isFunc())
+                continue;
+
+            Entry entry;
+            QString name = tag.getLongName();
+            entry.m_text = tag.getClassName().isEmpty() ? (" " + name) : name;
+            entry.m_filePath = tag.getFilePath();
+            entry.m_lineNo = tag.getLineNo();
+            entry.m_isClass = false;
+            sortList.append(qMakePair(entry.m_text, list.size()));
+            list.append(entry);
+            filterNameList.append(name);
+        }
+    }
+
+    // Sort them
+    std::sort(sortList.begin(), sortList.end(), textLessThan);
+    QVector<Entry> sortedList;
+    QStringList sortedFilterNameList;
+    sortedList.reserve(list.size());
+    for(int i = 0;i < sortList.size();i++)
+    {
+        sortedList.append(list[sortList[i].second]);
+        sortedFilterNameList.append(filterNameList[sortList[i].second]);
+    }
+
+    setEntries(sortedList, QVector<Entry>(), sortedFilterNameList);
+}
+
+
+/**
+ * @brief Fills the model with all classes and their functions.
+ * @param fileList   The files to show the classes of (the source files of the program).
+ */
+void TagListModel::setClasses(const SymbolIndex &index, QStringList fileList)
+{
+    QVector<Entry> list;
+    QVector<Entry> childList;
+    QStringList classList = index.getClassList();
+    QStringList shownClassList;
+    classList.sort();
+
+    // (The index also has the tags of other files, Eg: system headers opened in a tab)
+    QSet<QString> fileSet;
+    for(int i = 0;i < fileList.size();i++)
+        fileSet.insert(fileList[i]);
+
+    for(int ci = 0;ci < classList.size();ci++)
+    {
+        QString className = classList[ci];
+
+        Entry classEntry;
+        classEntry.m_text = className;
+        classEntry.m_lineNo = 0;
+        classEntry.m_isClass = true;
+
+        // Add all functions of the class
+        QVector<SymbolIndex::TagId> idList = index.getClassMembers(className);
+        bool isInSource = false;
+        for(int i = 0;i < idList.size();i++)
+        {
+            const Tag &tag = index.getTag(idList[i]);
+            if(!fileSet.contains(tag.getFilePath()))
+                continue;
+            isInSource = true;
+            if(tag.isFunc())
+            {
+                Entry entry;
+                entry.m_text = tag.getName() + tag.getSignature();
+                entry.m_filePath = tag.getFilePath();
+                entry.m_lineNo = tag.getLineNo();
+                entry.m_isClass = false;
+                classEntry.m_children.append(childList.size());
+                childList.append(entry);
+            }
+        }
+        if(isInSource)
+        {
+            list.append(classEntry);
+            shownClassList.append(className);
+        }
+    }
+
+    setEntries(list, childList, shownClassList);
+}
+
+
+void TagListModel::setEntries(const QVector<Entry> &entryList, const QVector<Entry> &childList, const QStringList &filterNameList)
+{
+    beginResetModel();
+    m_entries = entryList;
+    m_childEntries = childList;
+    m_visibleRows.clear();
+    m_entryToRow.fill(-1, m_entries.size());
+    endResetModel();
+
+    m_filter.setNames(filterNameList);
+    m_filter.start();
+}
+
+
+/**
+ * @brief Sets the filter ("Filter1;Filter2;...").
+ */
+void TagListModel::setFilterText(QString text)
+{
+    m_filter.setFilterText(text);
+}
+
+
+/**
+ * @brief Called when the filter is about to be reevaluated.
+ */
+void TagListModel::onFilterReset()
+{
+    beginResetModel();
+    m_visibleRows.clear();
+    m_entryToRow.fill(-1, m_entries.size());
+    endResetModel();
+}
+
+
+/**
+ * @brief Called when the filter has found more entries to show.
+ */
+void TagListModel::onRowsAccepted(QVector<int> rowList)
+{
+    int firstRow = m_visibleRows.size();
+    beginInsertRows(QModelIndex(), firstRow, firstRow + rowList.size()-1);
+    for(int i = 0;i < rowList.size();i++)
+    {
+        m_entryToRow[rowList[i]] = m_visibleRows.size();
+        m_visibleRows.append(rowList[i]);
+    }
+    endInsertRows();
+}
+
+
+/**
+ * @brief Returns the total number of children of the visible entries.
+ */
+int TagListModel::getVisibleChildCount() const
+{
+    int cnt = 0;
+    for(int row = 0;row < m_visibleRows.size();row++)
+        cnt += m_entries[m_visibleRows[row]].m_children.size();
+    return cnt;
+}
+
+
+const TagListModel::Entry *TagListModel::getEntry(const QModelIndex &index) const
+{
+    if(!index.isValid())
+        return NULL;
+    if(index.internalId() == 0)
+        return &m_entries[m_visibleRows[index.row()]];
+    const Entry &parentEntry = m_entries[(int)index.internalId()-1];
+    return &m_childEntries[parentEntry.m_children[index.row()]];
+}
+
+
+/**
+ * @brief Returns the location of a function.
+ * @return false if the index is not a function.
+ */
+bool TagListModel::getLocation(const QModelIndex &index, QString *filePath, int *lineNo) const
+{
+    const Entry *entry = getEntry(index);
+    if(entry == NULL || entry->m_isClass)
+        return false;
+    *filePath = entry->m_filePath;
+    *lineNo = entry->m_lineNo;
+    return true;
+}
+
+
+QModelIndex TagListModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if(!hasIndex(row, column, parent))
+        return QModelIndex();
+
+    // Top level items has internalId 0 and children has the parent entry index+1
+    if(!parent.isValid())
+        return createIndex(row, column, quintptr(0));
+    return createIndex(row, column, quintptr(m_visibleRows[parent.row()]+1));
+}
+
+
+QModelIndex TagListModel::parent(const QModelIndex &index) const
+{
+    if(!index.isValid() || index.internalId() == 0)
+        return QModelIndex();
+    int parentRow = m_entryToRow[(int)index.internalId()-1];
+    return createIndex(parentRow, 0, quintptr(0));
+}
+
+
+int TagListModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.column() > 0)
+        return 0;
+    if(!parent.isValid())
+        return m_visibleRows.size();
+    if(parent.internalId() == 0)
+        return m_entries[m_visibleRows[parent.row()]].m_children.size();
+    return 0;
+}
+
+
+int TagListModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+
+QVariant TagListModel::data(const QModelIndex &index, int role) const
+{
+    const Entry *entry = getEntry(index);
+    if(entry == NULL)
+        return QVariant();
+
+    if(role == Qt::DisplayRole)
+    {
+        if(index.column() == COLUMN_NAME)
+            return entry->m_text;
+        if(entry->m_isClass)
+            return QVariant();
+        if(index.column() == COLUMN_FILENAME)
+            return getFilenamePart(entry->m_filePath);
+        if(index.column() == COLUMN_LINE)
+            return QString::number(entry->m_lineNo);
+    }
+    else if(role == Qt::ForegroundRole)
+    {
+        if(entry->m_isClass && index.column() == COLUMN_NAME)
+            return QBrush(Qt::blue);
+    }
+    else if(role == Qt::ToolTipRole)
+    {
+        if(!entry->m_isClass && index.column() == COLUMN_FILENAME)
+            return entry->m_filePath;
+    }
+    return QVariant();
+}
+
+
+QVariant TagListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation == Qt::Horizontal && role == Qt::DisplayRole)
+    {
+        if(section == COLUMN_NAME)
+            return QString("Name");
+        else if(section == COLUMN_FILENAME)
+            return QString("Filename");
+        else if(section == COLUMN_LINE)
+            return QString("Line");
+    }
+    return QVariant();
+}
+
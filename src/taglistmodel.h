@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2018 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__TAGLISTMODEL_H
+#define FILE__TAGLISTMODEL_H
+
+#include <QAbstractItemModel>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QBitArray>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QTimer>
+
+#include "symbolindex.h"
+
+
+/**
+ * @brief Thread matching a list of names against wildcard patterns.
+ */
+class FilterWorker : public QThread
+{
+    Q_OBJECT
+
+public:
+    FilterWorker();
+    virtual ~FilterWorker();
+
+    void run();
+    void requestQuit();
+
+    void startJob(int generation, QStringList nameList, QStringList patternList, QList<QBitArray> candidateList);
+
+signals:
+    void onChunkDone(int generation, int startIdx, QList<QBitArray> matchList, bool done);
+
+private:
+    struct Job
+    {
+        int m_generation;
+        QStringList m_nameList;
+        QStringList m_patternList;
+        QList<QBitArray> m_candidateList; //!< Names to check for each pattern (empty for all)
+    };
+    void process(const Job &job);
+    bool isCancelled(int generation);
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_wait;
+    bool m_quit;
+    bool m_hasJob;
+    Job m_job;
+    int m_generation; //!< Generation of the latest job
+};
+
+
+/**
+ * @brief Filters a list of names with a list of wildcard patterns ("func*;*Test").
+ *
+ * The evaluation is started when the filter text has not changed for a
+ * while and is done in a separate thread. The matching names are
+ * reported in chunks. The result of each pattern is cached so only new
+ * patterns needs to be matched. A pattern which is a refinement of a
+ * cached pattern (Eg: "func*" => "func*Test") is only matched against the
+ * names that the cached pattern matched.
+ */
+class TagFilter : public QObject
+{
+    Q_OBJECT
+
+public:
+    TagFilter();
+    virtual ~TagFilter();
+
+    void setNames(QStringList nameList);
+    void setFilterText(QString text);
+
+    static QStringList parseFilterText(QString text);
+    static bool isRefinement(QString oldPattern, QString newPattern);
+
+signals:
+    void filterReset();
+    void rowsAccepted(QVector<int> rowList);
+    void filterDone();
+
+public slots:
+    void start();
+
+private slots:
+    void onChunkDone(int generation, int startIdx, QList<QBitArray> matchList, bool done);
+
+private:
+    QBitArray getCandidates(QString pattern);
+    void acceptRows(int startIdx, int endIdx);
+    void pruneCache();
+
+private:
+    FilterWorker m_worker;
+    QTimer m_timer;
+    QString m_filterText;
+    bool m_dirty; //!< True if the names has changed since the last evaluation
+    int m_generation;
+
+    QStringList m_nameList;
+    QStringList m_patterns;
+    QStringList m_pendingPatterns; //!< Patterns being matched by the worker
+    QHash<QString, QBitArray> m_cache; //!< Pattern => which names it matches
+    QStringList m_cacheOrder; //!< Most recently used pattern last
+};
+
+
+/**
+ * @brief Model for the list of functions or the list of classes.
+ */
+class TagListModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum { COLUMN_NAME = 0, COLUMN_FILENAME, COLUMN_LINE, COLUMN_COUNT };
+
+    TagListModel(QObject *parent = NULL);
+    virtual ~TagListModel();
+
+    void setFunctions(const SymbolIndex &index, QStringList fileList);
+    void setClasses(const SymbolIndex &index, QStringList fileList);
+
+    void setFilterText(QString text);
+
+    bool getLocation(const QModelIndex &index, QString *filePath, int *lineNo) const;
+    int getVisibleChildCount() const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &index) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+signals:
+    void filterDone();
+
+private slots:
+    void onFilterReset();
+    void onRowsAccepted(QVector<int> rowList);
+
+private:
+    struct Entry
+    {
+        QString m_text; //!< Text to display
+        QString m_filePath;
+        int m_lineNo;
+        bool m_isClass;
+        QVector<int> m_children; //!< Index in m_childEntries
+    };
+
+    void setEntries(const QVector<Entry> &entryList, const QVector<Entry> &childList, const QStringList &filterNameList);
+    const Entry *getEntry(const QModelIndex &index) const;
+
+private:
+    QVector<Entry> m_entries; //!< Top level entries
+    QVector<Entry> m_childEntries;
+    QVector<int> m_visibleRows; //!< The entries in m_entries that passes the filter
+    QVector<int> m_entryToRow; //!< The row of each entry in m_entries (-1 if not visible)
+    TagFilter m_filter;
+};
+
+
+#endif // FILE__TAGLISTMODEL_H
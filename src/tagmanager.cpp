@@ -11,10 +11,13 @@
  
 #include "tagmanager.h"
 
+#include <QFileInfo>
+
 #include "tagscanner.h"
 #include "mainwindow.h"
 #include "log.h"
 #include "util.h"
+#include "config.h"
 
 
 ScannerWorker::ScannerWorker()
@@ -29,20 +32,50 @@ ScannerWorker::ScannerWorker()
 
 void ScannerWorker::requestQuit()
 {
+    QMutexLocker locker(&m_mutex);
     m_quit = true;
     m_wait.wakeAll();
 }
-        
-void ScannerWorker::abort()
+
+
+/**
+ * @brief Removes all queued files.
+ * @return The files that was removed from the queue.
+ */
+QStringList ScannerWorker::abort()
 {
     QMutexLocker locker(&m_mutex);
+    QStringList removedList = m_workQueue;
     m_workQueue.clear();
+    return removedList;
+}
+
+/**
+ * @brief Removes a file from the queue.
+ * @return true if the file was queued.
+ */
+bool ScannerWorker::removeFromQueue(QString filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_workQueue.removeAll(filePath) > 0;
 }
 
+
+/**
+ * @brief Returns true if the worker is not scanning and has nothing queued.
+ */
 bool ScannerWorker::isIdle()
 {
     QMutexLocker locker(&m_mutex);
-    return m_isIdle;
+    return m_isIdle && m_workQueue.isEmpty();
+}
+
+
+void ScannerWorker::setPeers(QList<ScannerWorker*> peers)
+{
+    QMutexLocker locker(&m_mutex);
+    m_peers = peers;
+    m_peers.removeAll(this);
 }
 
     
@@ -53,24 +86,88 @@ void ScannerWorker::run()
     
     m_scanner.init(&m_cfg);
 
+    m_mutex.lock();
     while(m_quit == false)
     {
-        m_mutex.lock();
-        m_wait.wait(&m_mutex);
-        while(!m_workQueue.isEmpty())
+        QStringList filePathList;
+        while(!m_workQueue.isEmpty() && filePathList.size() < ETAGS_BATCH_SIZE)
+            filePathList.append(m_workQueue.takeFirst());
+
+        // Nothing left in our own queue? Try to get some work from the others.
+        if(filePathList.isEmpty())
+        {
+            m_isIdle = false;
+            m_mutex.unlock();
+
+            stealFromPeers(&filePathList);
+
+            m_mutex.lock();
+        }
+
+        if(filePathList.isEmpty())
+        {
+            m_isIdle = true;
+            m_doneCond.wakeAll();
+            if(m_workQueue.isEmpty() && m_quit == false)
+                m_wait.wait(&m_mutex);
+        }
+        else
         {
             m_isIdle = false;
-            QString filePath = m_workQueue.takeFirst();
             m_mutex.unlock();
 
-            scan(filePath);
+            scan(filePathList);
 
             m_mutex.lock();
         }
-        m_isIdle = true;
-        m_mutex.unlock();
-        m_doneCond.wakeAll();
     }
+    m_isIdle = true;
+    m_mutex.unlock();
+    m_doneCond.wakeAll();
+}
+
+
+/**
+ * @brief Takes files from the back of the queue (called by other workers).
+ * @return Number of files taken.
+ */
+int ScannerWorker::stealWork(QStringList *filePathList)
+{
+    QMutexLocker locker(&m_mutex);
+    int cnt = qMin((m_workQueue.size()+1) / 2, ETAGS_BATCH_SIZE);
+    for(int i = 0;i < cnt;i++)
+        filePathList->prepend(m_workQueue.takeLast());
+    return cnt;
+}
+
+
+/**
+ * @brief Steals work from the peer which has the longest queue.
+ */
+void ScannerWorker::stealFromPeers(QStringList *filePathList)
+{
+    QList<ScannerWorker*> peers;
+    m_mutex.lock();
+    peers = m_peers;
+    m_mutex.unlock();
+
+    ScannerWorker *victim = NULL;
+    int victimQueueSize = 0;
+    for(int i = 0;i < peers.size();i++)
+    {
+        ScannerWorker *peer = peers[i];
+        peer->m_mutex.lock();
+        int queueSize = peer->m_workQueue.size();
+        peer->m_mutex.unlock();
+        if(queueSize > victimQueueSize)
+        {
+            victim = peer;
+            victimQueueSize = queueSize;
+        }
+    }
+
+    if(victim)
+        victim->stealWork(filePathList);
 }
 
 
@@ -92,11 +189,11 @@ void ScannerWorker::waitAll()
     
 }
 
-void ScannerWorker::queueScan(QString filePath)
+void ScannerWorker::queueScan(QStringList filePathList)
 {
     m_mutex.lock();
     m_isIdle = false;
-    m_workQueue.append(filePath);
+    m_workQueue.append(filePathList);
     m_mutex.unlock();
     m_wait.wakeAll();
 }
@@ -104,18 +201,30 @@ void ScannerWorker::queueScan(QString filePath)
 
 
 
-void ScannerWorker::scan(QString filePath)
+/**
+ * @brief Scans a batch of files and reports the result for each file.
+ */
+void ScannerWorker::scan(QStringList filePathList)
 {
-    QList<Tag> *taglist = new QList<Tag>;
-    
+    QMap<QString, QList<Tag> > tagMap;
 
     assert(m_dbgMainThread != QThread::currentThreadId ());
+
+    // (Taken before the scan so that a file modified during the scan is scanned again)
+    QList<QDateTime> modTimeList;
+    for(int i = 0;i < filePathList.size();i++)
+        modTimeList.append(QFileInfo(filePathList[i]).lastModified());
     
-    
-    m_scanner.scan(filePath, taglist);
+    m_scanner.scan(filePathList, &tagMap);
 
+    for(int i = 0;i < filePathList.size();i++)
+    {
+        QString filePath = filePathList[i];
+        QList<Tag> *taglist = new QList<Tag>;
+        *taglist = tagMap.value(filePath);
 
-    emit onScanDone(filePath, taglist);
+        emit onScanDone(filePath, taglist, modTimeList[i]);
+    }
 }
 
 
@@ -125,21 +234,36 @@ TagManager::TagManager(Settings &cfg)
     m_dbgMainThread = QThread::currentThreadId ();
 #endif
 
-    m_worker.setConfig(cfg);
-    m_worker.start();
-    
-    connect(&m_worker, SIGNAL(onScanDone(QString, QList<Tag>* )), this, SLOT(onScanDone(QString, QList<Tag>* )));
-    
     m_cfg = cfg;
+
+    // Initialize (and check for ctags) before the workers are started
     m_tagScanner.init(&m_cfg);
 
+    int workerCount = qMax(1, QThread::idealThreadCount());
+    for(int i = 0;i < workerCount;i++)
+    {
+        ScannerWorker *worker = new ScannerWorker;
+        worker->setConfig(cfg);
+        connect(worker, SIGNAL(onScanDone(QString, QList<Tag>*, QDateTime)), this, SLOT(onScanDone(QString, QList<Tag>*, QDateTime)));
+        m_workers.append(worker);
+    }
+    for(int i = 0;i < m_workers.size();i++)
+    {
+        m_workers[i]->setPeers(m_workers);
+        m_workers[i]->start();
+    }
+    debugMsg("Started %d tag scanner threads", workerCount);
 }
 
 TagManager::~TagManager()
 {
-    m_worker.requestQuit();
-    m_worker.wait();
-
+    for(int i = 0;i < m_workers.size();i++)
+        m_workers[i]->requestQuit();
+    for(int i = 0;i < m_workers.size();i++)
+    {
+        m_workers[i]->wait();
+        delete m_workers[i];
+    }
     
     foreach (ScannerResult* info, m_db)
     {
@@ -147,20 +271,48 @@ TagManager::~TagManager()
     }
 }
 
+
+/**
+ * @brief Returns true if none of the workers has anything to do.
+ */
+bool TagManager::isIdle()
+{
+    for(int i = 0;i < m_workers.size();i++)
+    {
+        if(!m_workers[i]->isIdle())
+            return false;
+    }
+    return true;
+}
+
+
 void TagManager::waitAll()
 {
-    m_worker.waitAll();
+    // A worker may steal work from a worker that we already waited for.
+    do
+    {
+        for(int i = 0;i < m_workers.size();i++)
+            m_workers[i]->waitAll();
+    } while(!isIdle());
 }
 
 
 
-void TagManager::onScanDone(QString filePath, QList<Tag> *tags)
+void TagManager::onScanDone(QString filePath, QList<Tag> *tags, QDateTime modTime)
 {
     assert(m_dbgMainThread == QThread::currentThreadId ());
 
+    // Removed (or aborted) while it was scanned?
+    if(m_removedScans.remove(filePath) || !m_pendingScans.contains(filePath))
+    {
+        delete tags;
+        return;
+    }
+
     ScannerResult *info = new ScannerResult;
     info->m_filePath = filePath;
     info->m_tagList = *tags;
+    info->m_modTime = modTime;
 
     if(m_db.contains(filePath))
     {
@@ -169,33 +321,54 @@ void TagManager::onScanDone(QString filePath, QList<Tag> *tags)
     }
 
     m_db[filePath] = info;
-
-    if(m_worker.isIdle())
-        emit onAllScansDone();
+    m_index.setFileTags(filePath, info->m_tagList);
 
     delete tags;
+
+    // Was it the last one?
+    m_pendingScans.remove(filePath);
+    if(m_pendingScans.isEmpty())
+        emit onAllScansDone();
 }
 
 /**
  * @brief Tags a scan to be made later (in a seperate thread).
+ *
+ * The files are divided between the workers in the pool.
+ * onAllScansDone() is emitted once all of the queued files has been scanned.
  */
 int TagManager::queueScan(QStringList filePathList)
 {
-    bool queuedAny = false;
+    QStringList queueList;
 
     assert(m_dbgMainThread == QThread::currentThreadId ());
     for(int i = 0;i < filePathList.size();i++)
     {
         QString filePath = filePathList[i];
-        if(!m_db.contains(filePath))
+        if(!m_db.contains(filePath) && !m_pendingScans.contains(filePath))
         {
-            m_worker.queueScan(filePath);
-            queuedAny = true;
+            queueList.append(filePath);
+            m_pendingScans.insert(filePath);
         }
     }
 
-    if(!queuedAny)
-        emit onAllScansDone();
+    if(queueList.isEmpty())
+    {
+        if(m_pendingScans.isEmpty())
+            emit onAllScansDone();
+        return 0;
+    }
+
+    // Give each worker a continuous part of the list
+    int workerCount = m_workers.size();
+    int startIdx = 0;
+    for(int i = 0;i < workerCount;i++)
+    {
+        int endIdx = (queueList.size() * (i+1)) / workerCount;
+        if(endIdx > startIdx)
+            m_workers[i]->queueScan(queueList.mid(startIdx, endIdx-startIdx));
+        startIdx = endIdx;
+    }
 
     return 0;
 }
@@ -204,23 +377,73 @@ int TagManager::queueScan(QStringList filePathList)
 
 void TagManager::scan(QString filePath, QList<Tag> *tagList)
 {
+    // Scan the file again if it has been modified since it was scanned
+    QDateTime modTime = QFileInfo(filePath).lastModified();
+    if(m_db.contains(filePath) && m_db[filePath]->m_modTime != modTime)
+        delete m_db.take(filePath);
+
     if(!m_db.contains(filePath))
     {
         ScannerResult *res = new ScannerResult;
         res->m_filePath = filePath;
+        res->m_modTime = modTime;
 
         m_tagScanner.scan(res->m_filePath, &res->m_tagList);
 
         m_db[filePath] = res;
+        m_index.setFileTags(filePath, res->m_tagList);
     }
 
     *tagList = m_db[filePath]->m_tagList;
 
 }
 
+/**
+ * @brief Scans a file again (Eg: after it has been modified).
+ */
+void TagManager::rescan(QString filePath, QList<Tag> *tagList)
+{
+    if(m_db.contains(filePath))
+        delete m_db.take(filePath);
+
+    scan(filePath, tagList);
+}
+
+
+/**
+ * @brief Removes the tags of a file.
+ *
+ * A file that is still waiting to be scanned is removed from the queue and
+ * the result of a file that is being scanned is thrown away when it arrives.
+ */
+void TagManager::removeFile(QString filePath)
+{
+    if(m_pendingScans.remove(filePath))
+    {
+        bool wasQueued = false;
+        for(int i = 0;i < m_workers.size() && !wasQueued;i++)
+            wasQueued = m_workers[i]->removeFromQueue(filePath);
+        if(!wasQueued)
+            m_removedScans.insert(filePath);
+
+        if(m_pendingScans.isEmpty())
+            emit onAllScansDone();
+    }
+
+    if(m_db.contains(filePath))
+        delete m_db.take(filePath);
+    m_index.removeFile(filePath);
+}
+
+
 void TagManager::abort()
 {
-    m_worker.abort();
+    for(int i = 0;i < m_workers.size();i++)
+    {
+        QStringList removedList = m_workers[i]->abort();
+        for(int j = 0;j < removedList.size();j++)
+            m_pendingScans.remove(removedList[j]);
+    }
 }
 
 void TagManager::getTags(QString filePath, QList<Tag> *tagList)
@@ -241,36 +464,56 @@ void TagManager::lookupTag(QString name, QList<Tag> *tagList)
 {
     debugMsg("%s(name:'%s')", __func__, qPrintable(name)); 
 
-    QString funcName;
-    QString className;
+    QVector<SymbolIndex::TagId> idList = m_index.lookupQualifiedName(name);
+    for(int i = 0;i < idList.size();i++)
+        tagList->append(m_index.getTag(idList[i]));
+}
 
-    if(name.contains("::"))
-    {
-        int divPos = name.indexOf("::");
-        funcName = name.mid(divPos+2);
-        className = name.left(divPos);
-    }
-    else
-        funcName = name;
 
-    foreach (ScannerResult* info, m_db)
+/**
+ * @brief Lookup tags with a specific name regardless of which class they belong to.
+ * @param name       The name of the tag (Eg: "myFunc").
+ * @return tagList   The found tags.
+ */
+void TagManager::lookupName(QString name, QList<Tag> *tagList)
+{
+    QVector<SymbolIndex::TagId> idList = m_index.lookupName(name);
+    for(int i = 0;i < idList.size();i++)
+        tagList->append(m_index.getTag(idList[i]));
+}
+
+
+/**
+ * @brief Lookup functions with a specific name regardless of which class they belong to.
+ * @param name       The name of the function (Eg: "main").
+ * @return tagList   The found tags.
+ */
+void TagManager::lookupFunction(QString name, QList<Tag> *tagList)
+{
+    QVector<SymbolIndex::TagId> idList = m_index.lookupName(name);
+    for(int i = 0;i < idList.size();i++)
     {
-        for(int j = 0;j < info->m_tagList.size();j++)
-        {
-            Tag &tag = info->m_tagList[j];
-            
-            if(tag.getName() == funcName && className == tag.getClassName())
-                tagList->append(tag);
-            
-        }
+        const Tag &tag = m_index.getTag(idList[i]);
+        if(tag.isFunc())
+            tagList->append(tag);
     }
+}
 
+/**
+ * @brief Searches for tags in all scanned files.
+ */
+QVector<SymbolIndex::TagId> TagManager::searchSymbols(QString pattern, SymbolIndex::SearchMode mode)
+{
+    assert(m_dbgMainThread == QThread::currentThreadId ());
+    return m_index.search(pattern, mode);
 }
 
+
 void TagManager::setConfig(Settings &cfg)
 {
     m_cfg = cfg;
-    m_worker.setConfig(cfg);
+    for(int i = 0;i < m_workers.size();i++)
+        m_workers[i]->setConfig(cfg);
 }
 
 
@@ -7,9 +7,13 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QString>
+#include <QStringList>
 #include <QMap>
+#include <QSet>
+#include <QDateTime>
 
 #include "tagscanner.h"
+#include "symbolindex.h"
 
 class FileInfo;
 
@@ -17,8 +21,15 @@ struct ScannerResult
 {
     QString m_filePath;
     QList<Tag> m_tagList;
+    QDateTime m_modTime; //!< Modification time of the file when it was scanned.
 };
 
+/**
+ * @brief Thread scanning files for tags.
+ *
+ * Each worker has its own queue. A worker that runs out of work steals
+ * files from the back of the queues of the other workers in the pool.
+ */
 class ScannerWorker : public QThread
 {
     Q_OBJECT
@@ -28,21 +39,25 @@ class ScannerWorker : public QThread
 
         void run();
         
-        void abort();
+        QStringList abort();
+        bool removeFromQueue(QString filePath);
         void waitAll();
 
         void requestQuit();
-        void queueScan(QString filePath);
+        void queueScan(QStringList filePathList);
 
         bool isIdle();
 
         void setConfig(Settings cfg);
-        
+        void setPeers(QList<ScannerWorker*> peers);
+
     private:
-        void scan(QString filePath);
+        void scan(QStringList filePathList);
+        int stealWork(QStringList *filePathList);
+        void stealFromPeers(QStringList *filePathList);
     
     signals:
-        void onScanDone(QString filePath, QList<Tag> *taglist);
+        void onScanDone(QString filePath, QList<Tag> *taglist, QDateTime modTime);
 
     private:
         TagScanner m_scanner;
@@ -58,7 +73,7 @@ class ScannerWorker : public QThread
         bool m_quit;
         Settings m_cfg;
         bool m_isIdle;
-
+        QList<ScannerWorker*> m_peers;
 };
 
 
@@ -76,6 +91,8 @@ public:
 
     int queueScan(QStringList filePathList);
     void scan(QString filePath, QList<Tag> *tagList);
+    void rescan(QString filePath, QList<Tag> *tagList);
+    void removeFile(QString filePath);
 
     void waitAll();
 
@@ -84,22 +101,33 @@ public:
     void getTags(QString filePath, QList<Tag> *tagList);
 
     void lookupTag(QString name, QList<Tag> *tagList);
+    void lookupName(QString name, QList<Tag> *tagList);
+    void lookupFunction(QString name, QList<Tag> *tagList);
+
+    const SymbolIndex &getIndex() const { return m_index; };
+    QVector<SymbolIndex::TagId> searchSymbols(QString pattern, SymbolIndex::SearchMode mode);
 
     void setConfig(Settings &cfg);
 signals:
     void onAllScansDone();
     
 private slots:
-    void onScanDone(QString filePath, QList<Tag> *tags);
-    
+    void onScanDone(QString filePath, QList<Tag> *tags, QDateTime modTime);
+
+private:
+    bool isIdle();
+
 private:
-    ScannerWorker m_worker;
+    QList<ScannerWorker*> m_workers;
     TagScanner m_tagScanner;
+    QSet<QString> m_pendingScans; //!< Files queued but not yet reported by a worker.
+    QSet<QString> m_removedScans; //!< Files removed while a worker was scanning them.
 
 #ifndef NDEBUG
     Qt::HANDLE m_dbgMainThread;
 #endif
     QMap<QString, ScannerResult*> m_db;
+    SymbolIndex m_index;
 
     Settings m_cfg;
 };
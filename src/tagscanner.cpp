@@ -8,9 +8,6 @@
 
 #include "tagscanner.h"
 
-#ifdef QT_WIDGETS_LIB
-#include <QMessageBox>
-#endif
 #include <QProcess>
 #include <QDebug>
 #include <QFileInfo>
@@ -20,6 +17,7 @@
 #include "util.h"
 #include "rusttagscanner.h"
 #include "adatagscanner.h"
+#include "cxxtagscanner.h"
 
 
 static bool g_ctagsExist = true;
@@ -77,7 +75,10 @@ void Tag::dump() const
 TagScanner::TagScanner()
  : m_cfg(0)
 {
-
+    // The language scanners are kept to reuse their buffers between files
+    m_rustScanner = new RustTagScanner;
+    m_adaScanner = new AdaTagScanner;
+    m_cxxScanner = new CxxTagScanner;
 }
 
 void TagScanner::checkForCtags()
@@ -101,17 +102,10 @@ void TagScanner::checkForCtags()
     {
         QString msg;
 
-        msg = QString::asprintf("Failed to start program '%s/%s'\n", ETAGS_CMD1, ETAGS_CMD2);
-        msg += "ctags can be installed on ubuntu/debian using command:\n";
-        msg +=  "\n";
-        msg += " apt-get install exuberant-ctags";
-#ifdef QT_WIDGETS_LIB
-        QMessageBox::warning(NULL,
-                    "Failed to start ctags",
-                    msg);
-#else
-        printf(qPrintable(msg + "\n"));
-#endif
+        msg = QString::asprintf("Failed to find program '%s/%s'. ", ETAGS_CMD1, ETAGS_CMD2);
+        msg += "Using the builtin C/C++ tag scanner. ";
+        msg += "ctags can be installed on ubuntu/debian using command: 'apt-get install exuberant-ctags'";
+        warnMsg("%s", stringToCStr(msg));
     }
     else
     {
@@ -129,14 +123,9 @@ void TagScanner::checkForCtags()
         {
             QString msg;
 
-            msg = QString::asprintf("Failed to start program '%s'\n", qPrintable(g_ctagsCmd));
-#ifdef QT_WIDGETS_LIB
-            QMessageBox::warning(NULL,
-                        "Failed to start ctags",
-                        msg);
-#else
-            printf(qPrintable(msg + "\n"));
-#endif
+            msg = QString::asprintf("Failed to start program '%s'. ", qPrintable(g_ctagsCmd));
+            msg += "Using the builtin C/C++ tag scanner.";
+            warnMsg("%s", stringToCStr(msg));
 
             g_ctagsExist = false;
         }
@@ -151,7 +140,9 @@ void TagScanner::checkForCtags()
 
 TagScanner::~TagScanner()
 {
-
+    delete m_rustScanner;
+    delete m_adaScanner;
+    delete m_cxxScanner;
 }
 
 int TagScanner::execProgram(QString name, QStringList argList,
@@ -188,6 +179,10 @@ void TagScanner::init(Settings *cfg)
 {
     m_cfg = cfg;
 
+    m_rustScanner->setConfig(cfg);
+    m_adaScanner->setConfig(cfg);
+    m_cxxScanner->setConfig(cfg);
+
     checkForCtags();
     
 }
@@ -202,22 +197,18 @@ int TagScanner::scan(QString filepath, QList<Tag> *taglist)
     // Rust file?
     QString extension = getExtensionPart(filepath);
     if(extension.toLower() == RUST_FILE_EXTENSION)
-    {
-        RustTagScanner rs;
-        rs.setConfig(m_cfg);
-        return rs.scan(filepath, taglist);
-    }
+        return m_rustScanner->scan(filepath, taglist);
     if(extension.toLower() == ADA_FILE_EXTENSION)
-    {
-        AdaTagScanner rs;
-        rs.setConfig(m_cfg);
-        return rs.scan(filepath, taglist);
-    }
+        return m_adaScanner->scan(filepath, taglist);
 
 
 
     if(!g_ctagsExist)
-        return 0;
+    {
+        if(!CxxTagScanner::isCxxFile(filepath))
+            return 0;
+        return m_cxxScanner->scan(filepath, taglist);
+    }
 
     // Only scan if file exists
     if (!QFileInfo(filepath).exists())
@@ -242,7 +233,129 @@ int TagScanner::scan(QString filepath, QList<Tag> *taglist)
 
     parseOutput(stdoutContent, taglist);
 
-    // Display stderr
+    showErrors(stderrContent);
+
+    return rc;
+}
+
+
+/**
+ * @brief Scans a list of sourcefiles for tags.
+ *
+ * All C/C++ files are passed to a single ctags process (using a file list
+ * read from stdin) and the output is split up per file. If ctags is not
+ * available the C/C++ files are scanned with CxxTagScanner instead.
+ * @param tagMap   Receives the tags of each file. All files in filePathList gets an entry.
+ */
+int TagScanner::scan(QStringList filePathList, QMap<QString, QList<Tag> > *tagMap)
+{
+    int rc = 0;
+    QStringList ctagsFileList;
+
+    for(int i = 0;i < filePathList.size();i++)
+    {
+        QString filepath = filePathList[i];
+        QList<Tag> &taglist = (*tagMap)[filepath];
+
+        QString extension = getExtensionPart(filepath).toLower();
+        if(extension == RUST_FILE_EXTENSION || extension == ADA_FILE_EXTENSION)
+            scan(filepath, &taglist);
+        else if(!g_ctagsExist)
+        {
+            if(CxxTagScanner::isCxxFile(filepath) && m_cxxScanner->scan(filepath, &taglist))
+                rc = -1;
+        }
+        else if (!QFileInfo(filepath).exists())
+        {
+            warnMsg("Unable to scan '%s'. File not found!", qPrintable(filepath));
+            rc = -1;
+        }
+        else
+            ctagsFileList.append(filepath);
+    }
+
+    if(!ctagsFileList.isEmpty())
+    {
+        if(scanBatch(ctagsFileList, tagMap))
+            rc = -1;
+    }
+    return rc;
+}
+
+
+/**
+ * @brief Runs ctags on a list of files.
+ *
+ * The output is parsed while ctags is still running.
+ */
+int TagScanner::scanBatch(QStringList filePathList, QMap<QString, QList<Tag> > *tagMap)
+{
+    QString etagsCmd;
+    etagsCmd = ETAGS_ARGS;
+    etagsCmd += " -L -";
+    QStringList argList;
+    argList = etagsCmd.split(' ',  Qt::SkipEmptyParts);
+
+    QProcess proc;
+    proc.start(g_ctagsCmd, argList, QProcess::ReadWrite);
+    if(!proc.waitForStarted())
+    {
+        errorMsg("Failed to start '%s'", qPrintable(g_ctagsCmd));
+        return -1;
+    }
+
+    // Write the list of files to scan
+    proc.write(filePathList.join("\n").toLocal8Bit());
+    proc.write("\n");
+    proc.closeWriteChannel();
+
+    // Parse the rows as they arrive
+    QByteArray pending;
+    QList<Tag> *lastTagList = NULL;
+    QString lastFilePath;
+    bool finished = false;
+    while(!finished)
+    {
+        if(!proc.waitForReadyRead(-1))
+        {
+            proc.waitForFinished(-1);
+            finished = true;
+        }
+        pending += proc.readAllStandardOutput();
+
+        int startIdx = 0;
+        int endIdx;
+        while((endIdx = pending.indexOf('\n', startIdx)) != -1)
+        {
+            QByteArray row = pending.mid(startIdx, endIdx-startIdx);
+            startIdx = endIdx+1;
+
+            Tag tag;
+            if(row.isEmpty() || parseRow(row, &tag))
+                continue;
+
+            // Rows from the same file comes in sequence
+            if(lastTagList == NULL || tag.m_filepath != lastFilePath)
+            {
+                lastFilePath = tag.m_filepath;
+                lastTagList = &((*tagMap)[lastFilePath]);
+            }
+            lastTagList->push_back(tag);
+        }
+        pending.remove(0, startIdx);
+    }
+
+    showErrors(proc.readAllStandardError());
+
+    return proc.exitCode();
+}
+
+
+/**
+ * @brief Displays the stderr output from ctags.
+ */
+void TagScanner::showErrors(QByteArray stderrContent)
+{
     QString all = stderrContent;
     if(!all.isEmpty())
     {
@@ -260,93 +373,91 @@ int TagScanner::scan(QString filepath, QList<Tag> *taglist)
                 errorMsg("%s", stringToCStr(text));
         } 
     }
-
-    return rc;
 }
 
+
 int TagScanner::parseOutput(QByteArray output, QList<Tag> *taglist)
 {
     int n = 0;
     QList<QByteArray> rowList = output.split('\n');
 
-    /*
-       for(int rowIdx = 0;rowIdx < rowList.size();rowIdx++)
-       {
-       qDebug() << rowList[rowIdx];
-       }
-     */        
-
     for(int rowIdx = 0;rowIdx < rowList.size();rowIdx++)
     {
         QByteArray row = rowList[rowIdx];
         if(!row.isEmpty())
         {
-            QList<QByteArray> colList = row.split('\t');
+            Tag tag;
+            if(parseRow(row, &tag) == 0)
+                taglist->push_back(tag);
+        }
+    }
 
-            if(colList.size() < 5)
-            {
+    return n;
+}
 
-                errorMsg("Failed to parse output from ctags (%d)", colList.size());
-            }
-            else
-            {
 
-                Tag tag;
-
-                tag.m_name = colList[0];
-                tag.m_filepath = colList[1];
-                QString type = colList[3];
-                if(type == "v") // v = variable
-                    tag.m_type = Tag::TAG_VARIABLE;
-                else if(type == "f") // f = function
-                {
-                    tag.m_type = Tag::TAG_FUNC;
-                    tag.setSignature("()");
-                }
-                else if(type == "s") // s = subroutine?
-                {
-                    tag.m_type = Tag::TAG_FUNC;
-                    tag.setSignature("()");
-                }
-                else if(type == "p") // p = program?
-                {
-                    tag.m_type = Tag::TAG_FUNC;
-                    tag.setSignature("()");
-                }
-                else
-                {
-                    tag.m_type = Tag::TAG_VARIABLE;
-                    //debugMsg("Unknown type (%s) returned from ctags", stringToCStr(type));
-                }    
-                for(int colIdx = 4;colIdx < colList.size();colIdx++)
-                {
-                    QString field = colList[colIdx];
-                    int div = field.indexOf(':');
-                    if(div == -1)
-                        errorMsg("Failed to parse output from ctags (%d)", colList.size());
-                    else
-                    {
-                        QString fieldName = field.left(div);
-                        QString fieldData = field.mid(div+1);
-                        // qDebug() << '|' << fieldName << '|' << fieldData << '|';
-
-                        if(fieldName == "class")
-                            tag.m_className = fieldData;
-                        if(fieldName == "signature")
-                        {
-                            tag.setSignature(fieldData);
-                        }
-                        else if(fieldName == "line")
-                            tag.setLineNo(fieldData.toInt());
-                    }
-                }
+/**
+ * @brief Parses a single row of output from ctags.
+ * @return 0 on success.
+ */
+int TagScanner::parseRow(QByteArray row, Tag *tag)
+{
+    QList<QByteArray> colList = row.split('\t');
 
-                taglist->push_back(tag);
+    if(colList.size() < 5)
+    {
+        errorMsg("Failed to parse output from ctags (%d)", colList.size());
+        return -1;
+    }
+
+    tag->m_name = colList[0];
+    tag->m_filepath = colList[1];
+    QString type = colList[3];
+    if(type == "v") // v = variable
+        tag->m_type = Tag::TAG_VARIABLE;
+    else if(type == "f") // f = function
+    {
+        tag->m_type = Tag::TAG_FUNC;
+        tag->setSignature("()");
+    }
+    else if(type == "s") // s = subroutine?
+    {
+        tag->m_type = Tag::TAG_FUNC;
+        tag->setSignature("()");
+    }
+    else if(type == "p") // p = program?
+    {
+        tag->m_type = Tag::TAG_FUNC;
+        tag->setSignature("()");
+    }
+    else
+    {
+        tag->m_type = Tag::TAG_VARIABLE;
+        //debugMsg("Unknown type (%s) returned from ctags", stringToCStr(type));
+    }    
+    for(int colIdx = 4;colIdx < colList.size();colIdx++)
+    {
+        QString field = colList[colIdx];
+        int div = field.indexOf(':');
+        if(div == -1)
+            errorMsg("Failed to parse output from ctags (%d)", colList.size());
+        else
+        {
+            QString fieldName = field.left(div);
+            QString fieldData = field.mid(div+1);
+            // qDebug() << '|' << fieldName << '|' << fieldData << '|';
+
+            if(fieldName == "class")
+                tag->m_className = fieldData;
+            if(fieldName == "signature")
+            {
+                tag->setSignature(fieldData);
             }
+            else if(fieldName == "line")
+                tag->setLineNo(fieldData.toInt());
         }
     }
-
-    return n;
+    return 0;
 }
 
 
@@ -11,9 +11,14 @@
 
 #include <QString>
 #include <QList>
+#include <QMap>
+#include <QStringList>
 #include "settings.h"
 
 
+class RustTagScanner;
+class AdaTagScanner;
+class CxxTagScanner;
 
 class Tag
 {
@@ -52,10 +57,14 @@ class TagScanner
         void init(Settings *cfg);
 
         int scan(QString filepath, QList<Tag> *taglist);
+        int scan(QStringList filePathList, QMap<QString, QList<Tag> > *tagMap);
         void dump(const QList<Tag> &taglist);
 
     private:
+        int scanBatch(QStringList filePathList, QMap<QString, QList<Tag> > *tagMap);
         int parseOutput(QByteArray output, QList<Tag> *taglist);
+        int parseRow(QByteArray row, Tag *tag);
+        void showErrors(QByteArray stderrContent);
 
         void checkForCtags();
 
@@ -65,6 +74,9 @@ class TagScanner
 
 
         Settings *m_cfg;
+        RustTagScanner *m_rustScanner;
+        AdaTagScanner *m_adaScanner;
+        CxxTagScanner *m_cxxScanner;
 };
 
 
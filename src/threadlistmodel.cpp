@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2014-2020 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#include "threadlistmodel.h"
+
+#include "util.h"
+
+
+ThreadListModel::ThreadListModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+    m_fetchTimer.setSingleShot(true);
+    m_fetchTimer.setInterval(0);
+    connect(&m_fetchTimer, SIGNAL(timeout()), SLOT(onFetchTimeout()));
+}
+
+ThreadListModel::~ThreadListModel()
+{
+}
+
+
+/**
+ * @brief Returns the first row with a thread id lower or equal to threadId.
+ */
+int ThreadListModel::lowerBound(int threadId) const
+{
+    int first = 0;
+    int count = m_threads.size();
+    while(count > 0)
+    {
+        int step = count/2;
+        int mid = first + step;
+        if(m_threads[mid].m_info.m_id > threadId)
+        {
+            first = mid+1;
+            count -= step+1;
+        }
+        else
+            count = step;
+    }
+    return first;
+}
+
+
+/**
+ * @brief Returns the row of a thread or -1 if not found.
+ */
+int ThreadListModel::findRow(int threadId) const
+{
+    int row = lowerBound(threadId);
+    if(row < m_threads.size() && m_threads[row].m_info.m_id == threadId)
+        return row;
+    return -1;
+}
+
+
+/**
+ * @brief Adds a thread (or updates it if it already exists).
+ */
+void ThreadListModel::addThread(ThreadInfo info)
+{
+    int row = lowerBound(info.m_id);
+    if(row < m_threads.size() && m_threads[row].m_info.m_id == info.m_id)
+    {
+        updateThread(info);
+        return;
+    }
+
+    Entry entry;
+    entry.m_info = info;
+    entry.m_framesFetched = false;
+    entry.m_fetchPending = false;
+
+    beginInsertRows(QModelIndex(), row, row);
+    m_threads.insert(row, entry);
+    endInsertRows();
+}
+
+
+void ThreadListModel::updateThread(ThreadInfo info)
+{
+    int row = findRow(info.m_id);
+    if(row == -1)
+        return;
+    m_threads[row].m_info = info;
+    emit dataChanged(index(row, 0), index(row, COLUMN_COUNT-1));
+}
+
+
+void ThreadListModel::removeThread(int threadId)
+{
+    int row = findRow(threadId);
+    if(row == -1)
+        return;
+    beginRemoveRows(QModelIndex(), row, row);
+    m_threads.remove(row);
+    endRemoveRows();
+}
+
+
+void ThreadListModel::clear()
+{
+    beginResetModel();
+    m_threads.clear();
+    m_pendingFetches.clear();
+    endResetModel();
+}
+
+
+/**
+ * @brief Sets the stack frames of a thread.
+ */
+void ThreadListModel::setFrames(int threadId, QList<StackFrameEntry> frameList)
+{
+    int row = findRow(threadId);
+    if(row == -1)
+        return;
+    Entry &entry = m_threads[row];
+    QModelIndex threadIndex = index(row, 0);
+
+    if(!entry.m_frames.isEmpty())
+    {
+        beginRemoveRows(threadIndex, 0, entry.m_frames.size()-1);
+        entry.m_frames.clear();
+        endRemoveRows();
+    }
+
+    entry.m_framesFetched = true;
+    entry.m_fetchPending = false;
+    if(!frameList.isEmpty())
+    {
+        beginInsertRows(threadIndex, 0, frameList.size()-1);
+        entry.m_frames = frameList;
+        endInsertRows();
+    }
+}
+
+
+/**
+ * @brief Removes the stack frames of all threads (Eg: when the program resumes).
+ */
+void ThreadListModel::clearFrames()
+{
+    for(int row = 0;row < m_threads.size();row++)
+    {
+        Entry &entry = m_threads[row];
+        if(!entry.m_frames.isEmpty())
+        {
+            beginRemoveRows(index(row, 0), 0, entry.m_frames.size()-1);
+            entry.m_frames.clear();
+            endRemoveRows();
+        }
+        entry.m_framesFetched = false;
+        entry.m_fetchPending = false;
+    }
+    m_pendingFetches.clear();
+}
+
+
+/**
+ * @brief Returns the id of the thread at an index (or the thread of a frame).
+ * @return The id or -1 if the index is not valid.
+ */
+int ThreadListModel::getThreadId(const QModelIndex &index) const
+{
+    if(!index.isValid())
+        return -1;
+    if(index.internalId() != 0)
+        return (int)index.internalId()-1;
+    if(index.row() >= m_threads.size())
+        return -1;
+    return m_threads[index.row()].m_info.m_id;
+}
+
+
+/**
+ * @brief Returns the location of a stack frame.
+ * @return false if the index is not a stack frame.
+ */
+bool ThreadListModel::getFrameLocation(const QModelIndex &index, QString *filePath, int *lineNo) const
+{
+    if(!index.isValid() || index.internalId() == 0)
+        return false;
+    int row = findRow((int)index.internalId()-1);
+    if(row == -1 || index.row() >= m_threads[row].m_frames.size())
+        return false;
+    const StackFrameEntry &frame = m_threads[row].m_frames[index.row()];
+    if(frame.m_sourcePath.isEmpty())
+        return false;
+    *filePath = frame.m_sourcePath;
+    *lineNo = frame.m_line;
+    return true;
+}
+
+
+QModelIndex ThreadListModel::findThread(int threadId) const
+{
+    int row = findRow(threadId);
+    if(row == -1)
+        return QModelIndex();
+    return index(row, 0);
+}
+
+
+QModelIndex ThreadListModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if(!hasIndex(row, column, parent))
+        return QModelIndex();
+
+    // Threads has internalId 0 and frames has the thread id+1
+    if(!parent.isValid())
+        return createIndex(row, column, quintptr(0));
+    return createIndex(row, column, quintptr(m_threads[parent.row()].m_info.m_id+1));
+}
+
+
+QModelIndex ThreadListModel::parent(const QModelIndex &index) const
+{
+    if(!index.isValid() || index.internalId() == 0)
+        return QModelIndex();
+    int parentRow = findRow((int)index.internalId()-1);
+    if(parentRow == -1)
+        return QModelIndex();
+    return createIndex(parentRow, 0, quintptr(0));
+}
+
+
+int ThreadListModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.column() > 0)
+        return 0;
+    if(!parent.isValid())
+        return m_threads.size();
+    if(parent.internalId() == 0)
+        return m_threads[parent.row()].m_frames.size();
+    return 0;
+}
+
+
+int ThreadListModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return COLUMN_COUNT;
+}
+
+
+/**
+ * @brief Threads has children until their frames are known to be empty.
+ */
+bool ThreadListModel::hasChildren(const QModelIndex &parent) const
+{
+    if(!parent.isValid())
+        return !m_threads.isEmpty();
+    if(parent.internalId() != 0 || parent.column() > 0)
+        return false;
+    const Entry &entry = m_threads[parent.row()];
+    return !entry.m_framesFetched || !entry.m_frames.isEmpty();
+}
+
+
+bool ThreadListModel::canFetchMore(const QModelIndex &parent) const
+{
+    if(!parent.isValid() || parent.internalId() != 0)
+        return false;
+    const Entry &entry = m_threads[parent.row()];
+    return !entry.m_framesFetched && !entry.m_fetchPending;
+}
+
+
+void ThreadListModel::fetchMore(const QModelIndex &parent)
+{
+    if(!canFetchMore(parent))
+        return;
+    Entry &entry = m_threads[parent.row()];
+    entry.m_fetchPending = true;
+    m_pendingFetches.append(entry.m_info.m_id);
+    m_fetchTimer.start();
+}
+
+
+void ThreadListModel::onFetchTimeout()
+{
+    QList<int> threadIdList = m_pendingFetches;
+    m_pendingFetches.clear();
+    if(!threadIdList.isEmpty())
+        emit framesRequested(threadIdList);
+}
+
+
+QVariant ThreadListModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    // A stack frame?
+    if(index.internalId() != 0)
+    {
+        int row = findRow((int)index.internalId()-1);
+        if(row == -1 || index.row() >= m_threads[row].m_frames.size())
+            return QVariant();
+        const StackFrameEntry &frame = m_threads[row].m_frames[index.row()];
+        if(index.column() == COLUMN_NAME)
+            return frame.m_functionName;
+        else if(index.column() == COLUMN_DETAILS)
+        {
+            if(frame.m_sourcePath.isEmpty())
+                return QVariant();
+            return QString("%1:%2").arg(getFilenamePart(frame.m_sourcePath)).arg(frame.m_line);
+        }
+        return QVariant();
+    }
+
+    const ThreadInfo &info = m_threads[index.row()].m_info;
+    if(index.column() == COLUMN_NAME)
+        return info.m_name;
+    else if(index.column() == COLUMN_DETAILS)
+        return info.m_details;
+    return QVariant();
+}
+
+
+QVariant ThreadListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    if(section == COLUMN_NAME)
+        return QString("Name");
+    else if(section == COLUMN_DETAILS)
+        return QString("Details");
+    return QVariant();
+}
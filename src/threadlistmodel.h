@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2014-2020 Johan Henriksson.
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD license.  See the LICENSE file for details.
+ */
+
+#ifndef FILE__THREADLISTMODEL_H
+#define FILE__THREADLISTMODEL_H
+
+#include <QAbstractItemModel>
+#include <QVector>
+#include <QList>
+#include <QTimer>
+
+#include "core.h"
+
+
+/**
+ * @brief Model for the list of threads.
+ *
+ * The threads are kept sorted by id (newest thread first) so that a
+ * thread can be found, added or removed without touching the other rows.
+ *
+ * The stack frames of a thread are shown as its children. They are
+ * requested (with framesRequested()) when the thread is expanded. The
+ * requests made at the same time are collected so that they can be
+ * fetched with one batch of commands.
+ */
+class ThreadListModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum { COLUMN_NAME = 0, COLUMN_DETAILS, COLUMN_COUNT };
+
+    ThreadListModel(QObject *parent = NULL);
+    virtual ~ThreadListModel();
+
+    void addThread(ThreadInfo info);
+    void updateThread(ThreadInfo info);
+    void removeThread(int threadId);
+    void clear();
+
+    void setFrames(int threadId, QList<StackFrameEntry> frameList);
+    void clearFrames();
+
+    int getThreadId(const QModelIndex &index) const;
+    bool getFrameLocation(const QModelIndex &index, QString *filePath, int *lineNo) const;
+    QModelIndex findThread(int threadId) const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+    QModelIndex parent(const QModelIndex &index) const;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const;
+    bool canFetchMore(const QModelIndex &parent) const;
+    void fetchMore(const QModelIndex &parent);
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+signals:
+    void framesRequested(QList<int> threadIdList);
+
+private slots:
+    void onFetchTimeout();
+
+private:
+    struct Entry
+    {
+        ThreadInfo m_info;
+        bool m_framesFetched; //!< True if m_frames is valid.
+        bool m_fetchPending;
+        QList<StackFrameEntry> m_frames; //!< Innermost frame first.
+    };
+
+    int lowerBound(int threadId) const;
+    int findRow(int threadId) const;
+
+private:
+    QVector<Entry> m_threads; //!< Sorted with the highest id first.
+    QList<int> m_pendingFetches; //!< Threads to request the frames for.
+    QTimer m_fetchTimer;
+};
+
+
+#endif // FILE__THREADLISTMODEL_H
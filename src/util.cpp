@@ -280,6 +280,91 @@ QByteArray fileToContent(QString filename)
 }
 
 
+/**
+ * @brief Reads an unsigned integer from the header of an ELF file.
+ */
+static quint64 priv_getElfValue(const QByteArray &data, int offset, int size, bool isBigEndian)
+{
+    quint64 value = 0;
+    if(offset < 0 || offset+size > data.size())
+        return 0;
+    for(int i = 0;i < size;i++)
+    {
+        quint8 b = (quint8)data[isBigEndian ? offset+i : offset+size-1-i];
+        value = (value<<8) | b;
+    }
+    return value;
+}
+
+
+/**
+ * @brief Gets the names of the sections in an ELF file (Eg: ".text", ".gdb_index").
+ * @return 0 on success or -1 if the file is not an ELF file.
+ */
+int getElfSectionNames(QString filePath, QStringList *nameList)
+{
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    QByteArray header = file.read(64);
+    if(header.size() < 52 || !header.startsWith("\x7f" "ELF"))
+        return -1;
+    bool is64 = (header[4] == 2);
+    bool isBigEndian = (header[5] == 2);
+
+    quint64 shOffset;
+    int shEntrySize;
+    int shCount;
+    int shStrIdx;
+    if(is64)
+    {
+        shOffset = priv_getElfValue(header, 0x28, 8, isBigEndian);
+        shEntrySize = priv_getElfValue(header, 0x3a, 2, isBigEndian);
+        shCount = priv_getElfValue(header, 0x3c, 2, isBigEndian);
+        shStrIdx = priv_getElfValue(header, 0x3e, 2, isBigEndian);
+    }
+    else
+    {
+        shOffset = priv_getElfValue(header, 0x20, 4, isBigEndian);
+        shEntrySize = priv_getElfValue(header, 0x2e, 2, isBigEndian);
+        shCount = priv_getElfValue(header, 0x30, 2, isBigEndian);
+        shStrIdx = priv_getElfValue(header, 0x32, 2, isBigEndian);
+    }
+    if(shOffset == 0 || shCount == 0 || shStrIdx >= shCount || shEntrySize < (is64 ? 64 : 40))
+        return -1;
+
+    // Read the section headers
+    if(!file.seek(shOffset))
+        return -1;
+    QByteArray sections = file.read((qint64)shEntrySize*shCount);
+    if(sections.size() != shEntrySize*shCount)
+        return -1;
+
+    // Read the section name table
+    int strHeaderPos = shStrIdx*shEntrySize;
+    quint64 strOffset = priv_getElfValue(sections, strHeaderPos + (is64 ? 0x18 : 0x10), is64 ? 8 : 4, isBigEndian);
+    quint64 strSize = priv_getElfValue(sections, strHeaderPos + (is64 ? 0x20 : 0x14), is64 ? 8 : 4, isBigEndian);
+    quint64 fileSize = file.size();
+    if(strOffset > fileSize || strSize > fileSize - strOffset)
+        return -1;
+    if(!file.seek(strOffset))
+        return -1;
+    QByteArray strTable = file.read(strSize);
+
+    for(int i = 0;i < shCount;i++)
+    {
+        quint64 nameIdx = priv_getElfValue(sections, i*shEntrySize, 4, isBigEndian);
+        if(nameIdx < (quint64)strTable.size())
+        {
+            const char *name = strTable.constData()+nameIdx;
+            nameList->append(QString::fromLatin1(name, qstrnlen(name, strTable.size()-nameIdx)));
+        }
+    }
+    return 0;
+}
+
+
 /**
 * @brief Joins a QStringList into a string.
 */
@@ -367,6 +452,72 @@ QStringList splitString(QString str, char separator)
 }
 
 
+/**
+ * @brief Splits a list of expressions at a separator that is not within brackets or quotes.
+ * @param angleBrackets   True if '<' and '>' are brackets (Eg: "f<int,char>(1)").
+ * @return The expressions or an empty list if the brackets does not match.
+ */
+static QStringList priv_splitExpressionList(QString str, QChar separator, bool angleBrackets)
+{
+    QStringList list;
+    QString curExpr;
+    int depth = 0;
+    QChar quoteChar;
+    for(int i = 0;i < str.length();i++)
+    {
+        QChar c = str[i];
+        if(!quoteChar.isNull())
+        {
+            if(c == '\\' && i+1 < str.length())
+            {
+                curExpr += c;
+                c = str[++i];
+            }
+            else if(c == quoteChar)
+                quoteChar = QChar();
+        }
+        else if(c == '"' || c == '\'')
+            quoteChar = c;
+        else if(c == '(' || c == '[' || c == '{' || (angleBrackets && c == '<'))
+            depth++;
+        else if(c == ')' || c == ']' || c == '}' || (angleBrackets && c == '>'))
+        {
+            // (Eg: "p->x")
+            if(c == '>' && i > 0 && str[i-1] == '-')
+                depth++;
+            if(--depth < 0)
+                return QStringList();
+        }
+        else if(c == separator && depth == 0)
+        {
+            list.append(curExpr.trimmed());
+            curExpr.clear();
+            continue;
+        }
+        curExpr += c;
+    }
+    if(depth != 0)
+        return QStringList();
+    list.append(curExpr.trimmed());
+    return list;
+}
+
+
+/**
+ * @brief Splits a list of expressions (Eg: "f(a,b), arr[i]") at the separators that are not within brackets or quotes.
+ */
+QStringList splitExpressionList(QString str, QChar separator)
+{
+    // A '<' may also be a less than operator (Eg: "a<b, c")
+    QStringList list = priv_splitExpressionList(str, separator, true);
+    if(list.isEmpty())
+        list = priv_splitExpressionList(str, separator, false);
+    if(list.isEmpty())
+        list.append(str.trimmed());
+    return list;
+}
+
+
 #ifdef NEVER
 void testFuncs()
 {
@@ -11,6 +11,7 @@
 
 #include <QString>
 #include <QByteArray>
+#include <QStringList>
 
 #define MIN(a,b) ((a)<(b))
 #define MAX(a,b) ((a)>(b))
@@ -37,8 +38,11 @@ bool exeExists(QString name, bool checkCurrentDir = false);
 
 QByteArray fileToContent(QString filename);
 
+int getElfSectionNames(QString filePath, QStringList *nameList);
+
 QStringList splitString(QString str, char separator = ' ');
 QString joingStringList(QStringList arguments, char separator = ' ');
+QStringList splitExpressionList(QString str, QChar separator = ',');
 
 
 
@@ -479,6 +479,43 @@ void WatchVarCtl::onRemoveWatch()
 }
 
 
+/**
+ * @brief Sets a watchpoint on each of the selected variables.
+ */
+void WatchVarCtl::selectedSetWatchPoint(BreakPoint::WatchType type, bool autoContinue)
+{
+    Core &core = Core::getInstance();
+    QList<QTreeWidgetItem *> items = m_varWidget->selectedItems();
+    for(int i =0;i < items.size();i++)
+    {
+        QString watchId = getWatchId(items[i]);
+        if(core.getVarWatchInfo(watchId) != NULL)
+            core.gdbSetVarWatchPoint(watchId, type, autoContinue);
+    }
+}
+
+
+void WatchVarCtl::onBreakOnWrite()
+{
+    selectedSetWatchPoint(BreakPoint::WATCH_WRITE, false);
+}
+
+void WatchVarCtl::onBreakOnRead()
+{
+    selectedSetWatchPoint(BreakPoint::WATCH_READ, false);
+}
+
+void WatchVarCtl::onBreakOnAccess()
+{
+    selectedSetWatchPoint(BreakPoint::WATCH_ACCESS, false);
+}
+
+void WatchVarCtl::onLogWrites()
+{
+    selectedSetWatchPoint(BreakPoint::WATCH_WRITE, true);
+}
+
+
 
 /**
  * @brief Called when the user right clicks anywhere.
@@ -508,6 +545,15 @@ void WatchVarCtl::onContextMenu ( const QPoint &pos)
     action = m_popupMenu.addAction("Remove watch");
     action->setData(0);
     connect(action, SIGNAL(triggered()), this, SLOT(onRemoveWatch()));
+    m_popupMenu.addSeparator();
+    action = m_popupMenu.addAction("Break when changed");
+    connect(action, SIGNAL(triggered()), this, SLOT(onBreakOnWrite()));
+    action = m_popupMenu.addAction("Break when read");
+    connect(action, SIGNAL(triggered()), this, SLOT(onBreakOnRead()));
+    action = m_popupMenu.addAction("Break when accessed");
+    connect(action, SIGNAL(triggered()), this, SLOT(onBreakOnAccess()));
+    action = m_popupMenu.addAction("Log changes without stopping");
+    connect(action, SIGNAL(triggered()), this, SLOT(onLogWrites()));
 
         
     m_popupMenu.popup(m_varWidget->mapToGlobal(pos));
@@ -41,6 +41,7 @@ private:
     QString getWatchId(QTreeWidgetItem* item);
 
     void selectedChangeDisplayFormat(VarCtl::DispFormat fmt);
+    void selectedSetWatchPoint(BreakPoint::WatchType type, bool autoContinue);
 
     QString getDisplayString(QString watchId);
     
@@ -61,6 +62,10 @@ public slots:
     void onDisplayAsBin();
     void onDisplayAsChar();
     void onRemoveWatch();
+    void onBreakOnWrite();
+    void onBreakOnRead();
+    void onBreakOnAccess();
+    void onLogWrites();
 
 private:
     void fillInVars();
@@ -21,6 +21,11 @@ HEADERS += ../../src/rusttagscanner.h
 SOURCES += ../../src/adatagscanner.cpp
 HEADERS += ../../src/adatagscanner.h
 
+SOURCES += ../../src/cxxtagscanner.cpp
+HEADERS += ../../src/cxxtagscanner.h
+SOURCES += ../../src/syntaxhighlighter.cpp ../../src/syntaxhighlightercxx.cpp
+HEADERS += ../../src/syntaxhighlighter.h ../../src/syntaxhighlightercxx.h
+
 
 SOURCES += ../../src/ini.cpp ../../src/settings.cpp
 HEADERS += ../../src/ini.h ../../src/settings.h